@@ -0,0 +1,34 @@
+#include <iostream>
+#include "solver.h"
+
+// The board from puzzles/hardExample.csv as an 81 character literal, so the benchmark needs no input files
+static const char *HardPuzzle = "000000040000073000003051000300600000047010000005000002274000910100040680030000000";
+
+/**
+ * Microbenchmark for the ac3() kernel, the arc consistency pass run before every MAC solve
+ * Rebuilds the domains and runs AC-3 to fixpoint on the hard example board, reporting the average cost per pass
+ */
+int main() {
+    int board[9][9];
+    for (int square = 0; square < 81; square++) {
+        board[square / 9][square % 9] = HardPuzzle[square] - '0';
+    }
+
+    const long long iterations = 10000;
+    long long consistent = 0; // Accumulated so the passes can't be optimized away
+
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    for (long long i = 0; i < iterations; i++) {
+        Domain domains[9][9];
+        DomainTrail trail;
+        initDomains(board, domains);
+        if (ac3(domains, trail)) {
+            consistent++;
+        }
+    }
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+
+    double nanoseconds = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    cout << "ac3: " << iterations << " passes in " << (nanoseconds / 1000000.0) << "ms (" << (nanoseconds / iterations) << "ns/pass, " << consistent << " consistent)\n";
+    return 0;
+}
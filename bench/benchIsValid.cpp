@@ -0,0 +1,42 @@
+#include <iostream>
+#include "solver.h"
+
+// The board from puzzles/hardExample.csv as an 81 character literal, so the benchmark needs no input files
+static const char *HardPuzzle = "000000040000073000003051000300600000047010000005000002274000910100040680030000000";
+
+/**
+ * Microbenchmark for the isValid() kernel, the innermost check of the plain backtracking solvers
+ * Calls it for every empty square and value on the hard example board and reports the average cost per call
+ */
+int main() {
+    int board[9][9];
+    for (int square = 0; square < 81; square++) {
+        board[square / 9][square % 9] = HardPuzzle[square] - '0';
+    }
+
+    const long long iterations = 100000;
+    long long calls = 0;
+    long long validCount = 0; // Accumulated so the calls can't be optimized away
+
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    for (long long i = 0; i < iterations; i++) {
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                if (board[r][c] != 0) {
+                    continue;
+                }
+                for (int value = 1; value <= 9; value++) {
+                    if (isValid(board, r, c, value)) {
+                        validCount++;
+                    }
+                    calls++;
+                }
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+
+    double nanoseconds = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    cout << "isValid: " << calls << " calls in " << (nanoseconds / 1000000.0) << "ms (" << (nanoseconds / calls) << "ns/call, " << validCount << " valid)\n";
+    return 0;
+}
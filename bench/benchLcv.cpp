@@ -0,0 +1,40 @@
+#include <iostream>
+#include "solver.h"
+
+// The board from puzzles/hardExample.csv as an 81 character literal, so the benchmark needs no input files
+static const char *HardPuzzle = "000000040000073000003051000300600000047010000005000002274000910100040680030000000";
+
+/**
+ * Microbenchmark for the findValidLCV() kernel, the least constraining value ordering used by the LCV configurations
+ * Orders the values of every empty square on the hard example board and reports the average cost per square
+ */
+int main() {
+    int board[9][9];
+    for (int square = 0; square < 81; square++) {
+        board[square / 9][square % 9] = HardPuzzle[square] - '0';
+    }
+
+    const long long iterations = 10000; // LCV counts constraints across every peer, so each call is far heavier than isValid
+    long long calls = 0;
+    long long valuesOrdered = 0; // Accumulated so the calls can't be optimized away
+
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    for (long long i = 0; i < iterations; i++) {
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                if (board[r][c] != 0) {
+                    continue;
+                }
+                Domain validNums;
+                findValidLCV(board, r, c, validNums);
+                valuesOrdered += validNums.size();
+                calls++;
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+
+    double nanoseconds = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    cout << "findValidLCV: " << calls << " calls in " << (nanoseconds / 1000000.0) << "ms (" << (nanoseconds / calls) << "ns/call, " << valuesOrdered << " values ordered)\n";
+    return 0;
+}
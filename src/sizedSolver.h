@@ -0,0 +1,246 @@
+#ifndef SUDOKU_SIZED_SOLVER_H
+#define SUDOKU_SIZED_SOLVER_H
+
+#include "solver.h"
+
+/**
+ * Generic-size counterpart of MaskBoard for the 16x16 and 25x25 variants, with the board dimension as a template parameter
+ * Each supported size compiles to its own fully unrolled, constant-propagated engine, with the mask type sized to fit:
+ * 16-bit candidate sets fit an unsigned short, while 25x25 needs an unsigned int
+ * The 9x9 solvers in solver.h are untouched, so the hot path compiles exactly as before
+ */
+template<int Size>
+struct SizedBoard {
+    static constexpr int Box = Size == 9 ? 3 : (Size == 16 ? 4 : 5); // The subsquare dimension, so Size must be 9, 16 or 25
+    static_assert(Box * Box == Size, "Size must be 9, 16 or 25");
+    using Mask = typename conditional<(Size <= 16), unsigned short, unsigned int>::type;
+    static constexpr Mask Full = (Mask)((1u << Size) - 1); // All Size candidate bits set
+
+    int cells[Size][Size]; // The puzzle board
+    Mask rowUsed[Size]; // Used-value mask for each row
+    Mask colUsed[Size]; // Used-value mask for each column
+    Mask boxUsed[Size]; // Used-value mask for each subsquare
+
+    /**
+     * Loads an existing board into the engine and builds the row, column and subsquare masks from its filled squares
+     * @param board The puzzle board being loaded
+     */
+    void load(const int board[Size][Size]) {
+        for (int i = 0; i < Size; i++) {
+            rowUsed[i] = 0;
+            colUsed[i] = 0;
+            boxUsed[i] = 0;
+        }
+        for (int i = 0; i < Size; i++) {
+            for (int j = 0; j < Size; j++) {
+                cells[i][j] = 0;
+                if (board[i][j] != 0) {
+                    place(i, j, board[i][j]); // Rebuild the masks by placing each preset value
+                }
+            }
+        }
+    }
+
+    /**
+     * Calculates the index of the subsquare containing (row, col)
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    int boxIndex(int row, int col) {
+        return (row / Box) * Box + (col / Box);
+    }
+
+    /**
+     * Places a value into a square and marks it as used within the square's row, column and subsquare masks
+     * @param row The row of the square
+     * @param col The column of the square
+     * @param value The value being placed
+     */
+    void place(int row, int col, int value) {
+        Mask bit = (Mask)(1u << (value - 1));
+        cells[row][col] = value;
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[boxIndex(row, col)] |= bit;
+    }
+
+    /**
+     * Removes a square's value and clears it from the square's row, column and subsquare masks, used when backtracking
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    void unplace(int row, int col) {
+        Mask bit = (Mask)(1u << (cells[row][col] - 1));
+        cells[row][col] = 0;
+        rowUsed[row] &= (Mask)~bit;
+        colUsed[col] &= (Mask)~bit;
+        boxUsed[boxIndex(row, col)] &= (Mask)~bit;
+    }
+
+    /**
+     * Gets the mask of candidate values for a square, where bit (value - 1) is set if the value isn't used in the square's row, column or subsquare
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    int candidates(int row, int col) {
+        return (int)(~(rowUsed[row] | colUsed[col] | boxUsed[boxIndex(row, col)]) & Full);
+    }
+};
+
+/**
+ * Finds the empty square with the fewest candidate values (MRV) on a generic-size board, or (-1, -1) if none remain
+ * @param board The puzzle board
+ */
+template<int Size>
+pair<int, int> findEmptyMRVSized(SizedBoard<Size> &board) {
+    pair<int, int> best = {-1, -1};
+    int fewest = Size + 1;
+    for (int i = 0; i < Size; i++) {
+        for (int j = 0; j < Size; j++) {
+            if (board.cells[i][j] != 0) {
+                continue;
+            }
+            int count = countCandidates(board.candidates(i, j));
+            if (count < fewest) {
+                fewest = count;
+                best = {i, j};
+                if (count <= 1) {
+                    return best; // No square can beat a single candidate, so stop scanning
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * Finds all valid values for a given square on a generic-size board by expanding its candidate mask
+ * @param board The puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums The list the valid values are placed into
+ */
+template<int Size>
+void findValidSized(SizedBoard<Size> &board, int row, int col, SmallVec<int, Size> &validNums) {
+    validNums.clear();
+    int mask = board.candidates(row, col);
+    while (mask != 0) {
+        int bit = mask & -mask; // Isolate the lowest set candidate bit
+        int value = countCandidates(bit - 1) + 1; // The bit position gives the value
+        validNums.push_back(value);
+        mask &= mask - 1;
+    }
+}
+
+/**
+ * Checks if placing a value at (row, col) on a generic-size board has eliminated all remaining values for any square in its row, column or subsquare
+ * @param board The puzzle board
+ * @param row The row of the square that was just filled
+ * @param col The column of the square that was just filled
+ */
+template<int Size>
+bool hasFutureSizedPeers(SizedBoard<Size> &board, int row, int col) {
+    for (int i = 0; i < Size; i++) {
+        if (board.cells[row][i] == 0 && board.candidates(row, i) == 0) {
+            return false;
+        }
+        if (board.cells[i][col] == 0 && board.candidates(i, col) == 0) {
+            return false;
+        }
+    }
+    int boxRow = (row / SizedBoard<Size>::Box) * SizedBoard<Size>::Box;
+    int boxCol = (col / SizedBoard<Size>::Box) * SizedBoard<Size>::Box;
+    for (int r = boxRow; r < boxRow + SizedBoard<Size>::Box; r++) {
+        for (int c = boxCol; c < boxCol + SizedBoard<Size>::Box; c++) {
+            if (board.cells[r][c] == 0 && board.candidates(r, c) == 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Recursively solves a generic-size board using backtracking with forward checking and MRV on the sized bitmask engine
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * @param board The puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ */
+template<int Size>
+bool forwardCheckingSized(SizedBoard<Size> &board, int &steps, int &backtracks) {
+    pair<int, int> emptysquare = findEmptyMRVSized(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+
+    SmallVec<int, Size> validNums;
+    findValidSized(board, row, col, validNums);
+
+    for (int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board.place(row, col, validNums[i]);
+        if (!hasFutureSizedPeers(board, row, col)) { // If placing a value into this square eliminates all possible values for any other square, backtrack
+            board.unplace(row, col);
+            backtracks++;
+            continue;
+        }
+        if (forwardCheckingSized(board, steps, backtracks)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            board.unplace(row, col);
+        }
+    }
+    return false;
+}
+
+/**
+ * Stores the outcome of a generic-size solver run, mirroring SolveResult for the 16x16 and 25x25 variants
+ * @param cells The solved (or attempted) puzzle board
+ * @param solved Whether the solver found a valid solution
+ * @param steps The total number of recursion steps performed
+ * @param backtracks The total number of backtracks performed
+ * @param runtime The elapsed solving time in microseconds
+ */
+template<int Size>
+struct SizedResult {
+    int cells[Size][Size];
+    bool solved;
+    int steps;
+    int backtracks;
+    long long runtime;
+};
+
+/**
+ * Solves a generic-size board with forward checking and MRV on the sized bitmask engine, leaving the caller's board untouched
+ * @param cells The puzzle board to solve
+ */
+template<int Size>
+SizedResult<Size> solveSized(const int cells[Size][Size]) {
+    SizedBoard<Size> board;
+    board.load(cells);
+    int steps = 0;
+    int backtracks = 0;
+
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    bool solved = forwardCheckingSized(board, steps, backtracks);
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+
+    SizedResult<Size> result{};
+    for (int r = 0; r < Size; r++) {
+        for (int c = 0; c < Size; c++) {
+            result.cells[r][c] = board.cells[r][c];
+        }
+    }
+    result.solved = solved;
+    result.steps = steps;
+    result.backtracks = backtracks;
+    result.runtime = chrono::duration_cast<chrono::microseconds>(end - start).count();
+    return result;
+}
+
+#endif // SUDOKU_SIZED_SOLVER_H
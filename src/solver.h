@@ -0,0 +1,3179 @@
+#ifndef SUDOKU_SOLVER_H
+#define SUDOKU_SOLVER_H
+
+#include <vector>
+#include <chrono>
+#include <utility>
+#include <atomic>
+#include <random>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <fstream>
+using namespace std;
+
+/**
+ * Checks if a specified value is valid at a given position, by checking the position's row, column and 3x3 subsqaure to see if the value is already there
+ * @param board The 9x9 puzzle board
+ * @param row The row of the position being checked
+ * @param col The column of the position being checked
+ * @param value The value being checked
+*/
+inline bool isValid(int board[9][9], int row, int col, int value) {
+    for (int i=0; i < 9; i++) {
+        if (value == board[i][col] || value == board[row][i]) { // If the value is already within the position's row or column
+            return false;
+        }
+    }
+
+    int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
+    int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
+
+    for (int r = boxRow; r < boxRow + 3; r++) {
+        for (int c = boxCol; c < boxCol + 3; c++) {
+            if (value == board[r][c]) { // If the value is already within the subsquare
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Fixed-capacity vector stored entirely inline, used for the small lists in the solver hot path (domains hold at most 9 values,
+ * peers at most 20), so a full solve performs no heap allocation after setup
+ * @param items The inline storage for the elements
+ * @param count The number of elements currently held
+ */
+template<typename T, int Capacity>
+struct SmallVec {
+    T items[Capacity];
+    int count = 0;
+
+    int size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    void push_back(const T &value) {
+        items[count++] = value;
+    }
+
+    /**
+     * Inserts a value at the given position, shifting later elements up by one
+     * @param pos The position to insert at
+     * @param value The value being inserted
+     */
+    void insert(int pos, const T &value) {
+        for (int i = count; i > pos; i--) {
+            items[i] = items[i - 1];
+        }
+        items[pos] = value;
+        count++;
+    }
+
+    /**
+     * Removes the value at the given position, shifting later elements down by one
+     * @param pos The position to remove from
+     */
+    void erase(int pos) {
+        for (int i = pos; i < count - 1; i++) {
+            items[i] = items[i + 1];
+        }
+        count--;
+    }
+
+    SmallVec &operator=(initializer_list<T> values) {
+        count = 0;
+        for (const T &value : values) {
+            push_back(value);
+        }
+        return *this;
+    }
+
+    T &operator[](int i) {
+        return items[i];
+    }
+
+    const T &operator[](int i) const {
+        return items[i];
+    }
+
+    T *begin() {
+        return items;
+    }
+
+    T *end() {
+        return items + count;
+    }
+
+    const T *begin() const {
+        return items;
+    }
+
+    const T *end() const {
+        return items + count;
+    }
+};
+
+// Domains hold at most the 9 candidate values of a square, so they fit inline with no heap allocation
+using Domain = SmallVec<int, 9>;
+
+/**
+ * Counts the number of set bits within a 9-bit candidate mask, giving the number of candidate values it represents
+ * @param mask The 9-bit candidate mask being counted
+ */
+inline int countCandidates(int mask) {
+    int count = 0;
+    while (mask != 0) {
+        mask &= (mask - 1); // Clear the lowest set bit each iteration
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Alternative board engine to the raw 9x9 array, which maintains a 9-bit used-value mask for every row, column and 3x3 subsquare
+ * Bit (value - 1) of a mask is set when that value is already placed somewhere within the row/column/subsquare
+ * Masks are updated incrementally on every placement/removal, so finding a square's candidates is three mask reads instead of scanning 21 squares
+ */
+struct MaskBoard {
+    int cells[9][9]; // The 9x9 puzzle board
+    int rowUsed[9]; // Used-value mask for each row
+    int colUsed[9]; // Used-value mask for each column
+    int boxUsed[9]; // Used-value mask for each 3x3 subsquare
+
+    /**
+     * Loads an existing 9x9 board into the engine and builds the row, column and subsquare masks from its filled squares
+     * @param board The 9x9 puzzle board being loaded
+     */
+    void load(int board[9][9]) {
+        for (int i = 0; i < 9; i++) {
+            rowUsed[i] = 0;
+            colUsed[i] = 0;
+            boxUsed[i] = 0;
+        }
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < 9; j++) {
+                cells[i][j] = 0;
+                if (board[i][j] != 0) {
+                    place(i, j, board[i][j]); // Rebuild the masks by placing each preset value
+                }
+            }
+        }
+    }
+
+    /**
+     * Calculates the index of the 3x3 subsquare containing (row, col)
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    int boxIndex(int row, int col) {
+        return (row / 3) * 3 + (col / 3);
+    }
+
+    /**
+     * Places a value into a square and marks it as used within the square's row, column and subsquare masks
+     * @param row The row of the square
+     * @param col The column of the square
+     * @param value The value being placed
+     */
+    void place(int row, int col, int value) {
+        int bit = 1 << (value - 1);
+        cells[row][col] = value;
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[boxIndex(row, col)] |= bit;
+    }
+
+    /**
+     * Removes a square's value and clears it from the square's row, column and subsquare masks, used when backtracking
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    void unplace(int row, int col) {
+        int bit = 1 << (cells[row][col] - 1);
+        cells[row][col] = 0;
+        rowUsed[row] &= ~bit;
+        colUsed[col] &= ~bit;
+        boxUsed[boxIndex(row, col)] &= ~bit;
+    }
+
+    /**
+     * Gets the 9-bit mask of candidate values for a square, where bit (value - 1) is set if the value isn't used in the square's row, column or subsquare
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    int candidates(int row, int col) {
+        return ~(rowUsed[row] | colUsed[col] | boxUsed[boxIndex(row, col)]) & 0x1FF; // OR the used masks together and invert, keeping only the low 9 bits
+    }
+};
+
+/**
+ * Table of each square's 20 related squares (peers, within the same row, column or 3x3 subsquare), indexed by square (row * 9 + col)
+ * Peers are stored as flat square indices, so a peer's row is peer / 9 and its column is peer % 9
+ * @param peers The 81 x 20 table of peer square indices
+ */
+struct PeerTable {
+    int peers[81][20];
+};
+
+/**
+ * Builds the peer table for all 81 squares, keeping the same peer order the per-call scan produced (row and column interleaved, then the rest of the subsquare)
+ * Duplicates between the row/column peers and the subsquare peers are filtered while building, so lookups need no scanning at all
+ */
+constexpr PeerTable buildPeerTable() {
+    PeerTable table = {};
+    for (int row = 0; row < 9; row++) {
+        for (int col = 0; col < 9; col++) {
+            int square = row * 9 + col;
+            int count = 0;
+            for (int i = 0; i < 9; i++) {
+                if (i != col) {
+                    table.peers[square][count++] = row * 9 + i; // Get all squares within the same row
+                }
+                if (i != row) {
+                    table.peers[square][count++] = i * 9 + col; // Get all squares within the same column
+                }
+            }
+            int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
+            int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
+            for (int i = boxRow; i < boxRow + 3; i++) {
+                for (int j = boxCol; j < boxCol + 3; j++) {
+                    if (i == row && j == col) {
+                        continue;
+                    }
+                    bool duplicate = false;
+                    for (int k = 0; k < count; k++) {
+                        if (table.peers[square][k] == i * 9 + j) {
+                            duplicate = true; // Avoid adding any duplicates previously added when searching row and column
+                            break;
+                        }
+                    }
+                    if (!duplicate) {
+                        table.peers[square][count++] = i * 9 + j; // Get all squares within the same subsquare
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+// The peer sets of all 81 squares never change, so the table is initialized once at compile time
+constexpr PeerTable PEERS = buildPeerTable();
+
+/** 
+ * Iterates through values 1-9, and checks if each value is valid at the given row and column, updating the list of valid values as it goes
+ * @param board The 9x9 puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums Pointer to the list of valid values
+*/
+inline void findValid(int board[9][9], int row, int col, Domain &validNums) {
+    for (int i = 1; i < 10; i++) { // Get a list of all possible valid values at the current empty square
+        if (isValid(board, row, col, i)) {
+            validNums.push_back(i);
+        }
+    }
+}
+/**
+ * Updates the list of valid numbers to the current domain, used for MAC solving
+ * @param domains The 9x9 list of domains for each square
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums Pointer to the list of valid values
+ */
+inline void findValidMAC(Domain domains[9][9], int row, int col, Domain &validNums) {
+    validNums = domains[row][col];
+}
+
+/** 
+ * Iterates through values 1-9 and counts the number of constraints removed for each square in the given square's row, column and subsqaure for each value
+ * The list of valid values is then updated with each valid value, ordered from the least constraining to the highest constraining
+ * @param board The 9x9 puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums Pointer to the list of valid values
+*/
+inline void findValidLCV(int board[9][9], int row, int col, Domain &validNums) {
+    SmallVec<pair<int, int>, 9> valueConstraints; // Pairs of values and constraint counts
+    for (int i = 1; i < 10; i++) {
+        if (!isValid(board, row, col, i)) {
+            continue; // Skip invalid values
+        }
+        int constraints = 0;
+        board[row][col] = i;
+        
+        for (int j = 0; j < 9; j++) {
+            if (board[row][j] == 0 && j != col) { // Count constraints within each row
+                for (int k = 1; k < 10; k++) {
+                    if (isValid(board, row, j, k)) {
+                        constraints++;
+                    }
+                }
+            }
+            if (board[j][col] == 0 && j != row) { // Count constraints within each column
+                for (int k = 1; k < 10; k++) {
+                    if (isValid(board, j, col, k)) {
+                        constraints++;
+                    }
+                }
+            }
+        }
+        int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
+        int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
+        for (int r = boxRow; r < boxRow + 3; r++) { // Count constraints within each subsquare
+            for (int c = boxCol; c < boxCol + 3; c++) {
+                if (board[r][c] == 0 && (r != row || c != col)) {
+                    for (int v = 1; v < 10; v++) {
+                        if (isValid(board, r, c, v)) {
+                            constraints++;
+                        }
+                    }
+                }
+            }
+        }
+        board[row][col] = 0;
+        int pos = 0;
+        while (pos < valueConstraints.size() && valueConstraints[pos].second <= constraints) { 
+             pos++; // Find the position to insert the value and constraints pair, so that the vector is sorted ascendingly 
+        }
+        valueConstraints.insert(pos, {i, constraints}); // Insert the pair at the correct position
+    }
+
+    for (auto &p : valueConstraints) {
+        validNums.push_back(p.first); // Update validNums with the LCV sorted valid values
+    }
+}
+
+/**
+ * Gets the list of valid values for a square from the bitmask engine's candidate mask, one bit test per value instead of a full isValid scan
+ * @param board The bitmask puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums Pointer to the list of valid values
+ */
+inline void findValidMask(MaskBoard &board, int row, int col, Domain &validNums) {
+    int mask = board.candidates(row, col);
+    for (int i = 1; i < 10; i++) {
+        if (mask & (1 << (i - 1))) {
+            validNums.push_back(i);
+        }
+    }
+}
+
+/**
+ * Iterates through a square's candidate mask and counts the remaining candidates of every related empty square for each value
+ * The list of valid values is then updated with each valid value, ordered from the least constraining to the most constraining
+ * Placing a value at (row, col) removes exactly that value's bit from each related square's candidate mask, so the per-value counts
+ * are computed with a SWAR kernel: the candidate masks of every empty related square are packed once into 64-bit words (five 12-bit
+ * lanes per word), and each value's constraint count is then a handful of AND + popcount operations over the packed words instead of
+ * re-deriving every related square's candidates per value
+ * Counts match the scalar version exactly, including squares shared between the subsquare and the row/column being counted twice
+ * @param board The bitmask puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums Pointer to the list of valid values
+ */
+inline void findValidLCVMask(MaskBoard &board, int row, int col, Domain &validNums) {
+    SmallVec<pair<int, int>, 9> valueConstraints; // Pairs of values and constraint counts
+    int mask = board.candidates(row, col);
+
+    // Pack the candidate masks of every empty related square into 12-bit lanes, in the same row/column then subsquare order as before
+    unsigned long long packed[5] = {0, 0, 0, 0, 0};
+    int lane = 0;
+    for (int j = 0; j < 9; j++) {
+        if (board.cells[row][j] == 0 && j != col) { // Empty squares within the row
+            packed[lane / 5] |= static_cast<unsigned long long>(board.candidates(row, j)) << ((lane % 5) * 12);
+            lane++;
+        }
+        if (board.cells[j][col] == 0 && j != row) { // Empty squares within the column
+            packed[lane / 5] |= static_cast<unsigned long long>(board.candidates(j, col)) << ((lane % 5) * 12);
+            lane++;
+        }
+    }
+    int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
+    int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
+    for (int r = boxRow; r < boxRow + 3; r++) { // Empty squares within the subsquare
+        for (int c = boxCol; c < boxCol + 3; c++) {
+            if (board.cells[r][c] == 0 && (r != row || c != col)) {
+                packed[lane / 5] |= static_cast<unsigned long long>(board.candidates(r, c)) << ((lane % 5) * 12);
+                lane++;
+            }
+        }
+    }
+
+    for (int i = 1; i < 10; i++) {
+        if (!(mask & (1 << (i - 1)))) {
+            continue; // Skip invalid values
+        }
+        // Clear bit (i - 1) from every lane at once, then popcount whole words to sum the remaining candidates of all related squares
+        unsigned long long clear = ~(static_cast<unsigned long long>(1 << (i - 1)) * 0x0001001001001001ULL); // Replicates the value's bit into all five 12-bit lanes
+        int constraints = 0;
+        for (int w = 0; w < 5; w++) {
+            constraints += __builtin_popcountll(packed[w] & clear);
+        }
+        int pos = 0;
+        while (pos < valueConstraints.size() && valueConstraints[pos].second <= constraints) {
+            pos++; // Find the position to insert the value and constraints pair, so that the vector is sorted ascendingly
+        }
+        valueConstraints.insert(pos, {i, constraints}); // Insert the pair at the correct position
+    }
+
+    for (auto &p : valueConstraints) {
+        validNums.push_back(p.first); // Update validNums with the LCV sorted valid values
+    }
+}
+
+/**
+ * Iterates through values in a square's domain and counts the number of constraints each value would impose on related squares
+ * The list of valid values is then updated with each value, ordered from the least constraining to the most constraining
+ * Uses pre-computed domains from AC-3, so calculations are faster than recalculating constraints from scratch
+ * @param domains The 9x9 list of domains for each square
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums Pointer to the list of valid values
+*/
+inline void findValidLCVMAC(Domain domains[9][9], int row, int col, Domain &validNums) {
+    validNums.clear();
+    SmallVec<pair<int, int>, 9> valueConstraints; // Pairs of values and constraint counts
+    
+    for (int val : domains[row][col]) {
+        int constraints = 0; // Count of related squares that would have only 1 choice left
+
+        for (int peer : PEERS.peers[row * 9 + col]) { // Index straight into the precomputed peer table, no allocation or scanning
+            int squareRow = peer / 9;
+            int squareCol = peer % 9;
+            if (domains[squareRow][squareCol].empty()) continue;
+            
+            int supportedCount = 0;
+            for (int v : domains[squareRow][squareCol]) {
+                if (v != val) supportedCount++;
+            }
+            
+            if (supportedCount == 1) constraints += 100; // Heavy penalty
+            else constraints += supportedCount; // Light penalty for remaining options
+        }
+        
+        size_t pos = 0;
+        while (pos < valueConstraints.size() && valueConstraints[pos].second <= constraints) pos++;
+        valueConstraints.insert(pos, {val, constraints});
+    }
+    
+    for (auto &p : valueConstraints) validNums.push_back(p.first);
+}
+
+/**
+ * Initialising a list of initial domains for each square, by adding the square's set value or, if empty, all its potential values to the list
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains
+ */
+inline void initDomains(int board[9][9], Domain domains[9][9]) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            domains[i][j].clear(); // Clear any previously set domains
+            if (board[i][j] != 0) {
+                domains[i][j].push_back(board[i][j]); // Limit preset squares' domains to their preset value
+                continue;
+            }
+            for (int k = 1; k <= 9; k++) {
+                if (isValid(board, i, j, k)) {
+                    domains[i][j].push_back(k); // Iteratively add all valid values to the domain
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Records every domain value removed during propagation, so the removals can be rolled back on backtrack instead of deep copying all 81 domains per step
+ * @param removals The list of (row, col, value) removals, in the order they happened
+ */
+struct DomainTrail {
+    vector<pair<pair<int, int>, int>> removals;
+
+    /**
+     * Reserves the trail's worst case up front: each of the 81 squares can have at most 9 values removed at any moment,
+     * so recording removals never reallocates once the search is running
+     */
+    DomainTrail() {
+        removals.reserve(81 * 9);
+    }
+
+    /**
+     * Gets the current position in the trail, to be passed to undoTo() when backtracking past this point
+     */
+    int mark() {
+        return removals.size();
+    }
+
+    /**
+     * Records a single value being removed from a square's domain
+     * @param row The row of the square
+     * @param col The column of the square
+     * @param value The value removed from the square's domain
+     */
+    void record(int row, int col, int value) {
+        removals.push_back({{row, col}, value});
+    }
+
+    /**
+     * Rolls the domains back to a previously taken mark, reinserting every removed value in ascending position so domains stay sorted
+     * @param markPoint The trail position returned by mark() before the removals being undone
+     * @param domains The 9x9 list of domains being restored
+     */
+    void undoTo(int markPoint, Domain domains[9][9]) {
+        while (removals.size() > markPoint) {
+            auto removal = removals.back();
+            removals.pop_back();
+            Domain &domain = domains[removal.first.first][removal.first.second];
+            int pos = 0;
+            while (pos < domain.size() && domain[pos] < removal.second) {
+                pos++; // Find the ascending position so the domain keeps its original order
+            }
+            domain.insert(pos, removal.second);
+        }
+    }
+};
+
+#ifdef SUDOKU_INSTRUMENT
+/**
+ * Opt-in instrumentation for the search, compiled in only when SUDOKU_INSTRUMENT is defined so the normal build pays nothing for it
+ * Records per-depth node counts, the depth distribution of backtracks, which squares get their domains wiped out, and how much of the
+ * solve is spent in propagation versus search, and enforces optional node/time budgets that abort runaway solves with partial stats
+ * The stats are thread local, so every batch worker and portfolio racer records into its own copy
+ * @param nodesAtDepth Number of search nodes entered at each depth
+ * @param backtracksAtDepth Number of backtracks performed at each depth
+ * @param wipeouts Number of domain wipeouts observed at each square (row * 9 + col)
+ * @param propagationUs Total time spent inside propagation, in microseconds
+ * @param totalNodes The total number of search nodes entered
+ * @param depth The current search depth
+ * @param nodeBudget Abort the solve after this many nodes (0 for unlimited)
+ * @param timeBudgetUs Abort the solve after this much time in microseconds (0 for unlimited)
+ * @param budgetExceeded Whether the solve was aborted by a budget
+ * @param searchStart When the solve started, for the time budget
+ */
+struct SearchStats {
+    long long nodesAtDepth[82];
+    long long backtracksAtDepth[82];
+    long long wipeouts[81];
+    long long propagationUs;
+    long long totalNodes;
+    int depth;
+    long long nodeBudget;
+    long long timeBudgetUs;
+    bool budgetExceeded;
+    chrono::steady_clock::time_point searchStart;
+};
+
+inline thread_local SearchStats searchStats;
+
+/**
+ * Clears the stats and arms the budgets at the start of a solve
+ * @param nodeBudget Abort the solve after this many nodes (0 for unlimited)
+ * @param timeBudgetUs Abort the solve after this much time in microseconds (0 for unlimited)
+ */
+inline void statsReset(long long nodeBudget, long long timeBudgetUs) {
+    searchStats = {};
+    searchStats.nodeBudget = nodeBudget;
+    searchStats.timeBudgetUs = timeBudgetUs;
+    searchStats.searchStart = chrono::steady_clock::now();
+}
+
+/**
+ * Checks the node and time budgets, marking the solve as aborted once either is exhausted
+ * Returns false when the budget is exhausted and the search should unwind
+ * The clock is only read every 256 nodes, so the time budget costs next to nothing per node
+ */
+inline bool statsCheckBudget() {
+    if (searchStats.budgetExceeded) {
+        return false;
+    }
+    if (searchStats.nodeBudget > 0 && searchStats.totalNodes > searchStats.nodeBudget) {
+        searchStats.budgetExceeded = true;
+        return false;
+    }
+    if (searchStats.timeBudgetUs > 0 && (searchStats.totalNodes & 255) == 0) {
+        auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - searchStats.searchStart).count();
+        if (elapsed > searchStats.timeBudgetUs) {
+            searchStats.budgetExceeded = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Tracks one search node for the duration of its solver call, counting it at its depth on entry and restoring the depth on every exit path
+ */
+struct StatsNodeScope {
+    StatsNodeScope() {
+        searchStats.depth++;
+        searchStats.totalNodes++;
+        if (searchStats.depth < 82) {
+            searchStats.nodesAtDepth[searchStats.depth]++;
+        }
+    }
+    ~StatsNodeScope() {
+        searchStats.depth--;
+    }
+};
+
+/**
+ * Records a single backtrack at the current search depth
+ */
+inline void statsBacktrack() {
+    if (searchStats.depth >= 0 && searchStats.depth < 82) {
+        searchStats.backtracksAtDepth[searchStats.depth]++;
+    }
+}
+
+/**
+ * Records a domain wipeout at the given square
+ * @param row The row of the wiped out square
+ * @param col The column of the wiped out square
+ */
+inline void statsWipeout(int row, int col) {
+    searchStats.wipeouts[row * 9 + col]++;
+}
+
+/**
+ * Accumulates time spent in propagation for the duration of a propagation call, so it can be reported separately from search time
+ */
+struct StatsPropagationScope {
+    chrono::steady_clock::time_point start;
+    StatsPropagationScope() {
+        start = chrono::steady_clock::now();
+    }
+    ~StatsPropagationScope() {
+        searchStats.propagationUs += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+// The solver bodies use these, so the instrumented build records everything and the normal build compiles them away entirely
+#define STATS_NODE_SCOPE() StatsNodeScope statsScope; if (!statsCheckBudget()) return false
+#define STATS_BACKTRACK() statsBacktrack()
+#define STATS_WIPEOUT(row, col) statsWipeout(row, col)
+#define STATS_PROPAGATION_SCOPE() StatsPropagationScope statsPropagationScope
+#else
+#define STATS_NODE_SCOPE()
+#define STATS_BACKTRACK()
+#define STATS_WIPEOUT(row, col)
+#define STATS_PROPAGATION_SCOPE()
+#endif // SUDOKU_INSTRUMENT
+
+/**
+ * Fixed-capacity queue of squares pending singleton propagation, stored entirely inline on the SmallVec idiom
+ * A square is only enqueued when its domain becomes a singleton, which happens at most once per propagation wave, so 81 slots
+ * never overflow; popping advances a head index instead of shifting. This keeps the whole propagation path free of the per-node
+ * heap traffic a std::queue's backing deque would cost
+ * @param items The queued squares in arrival order
+ * @param head The index of the next square to pop
+ */
+struct PendingQueue {
+    SmallVec<pair<int, int>, 81> items;
+    int head = 0;
+
+    bool empty() const {
+        return head >= items.size();
+    }
+
+    void push(pair<int, int> square) {
+        items.push_back(square);
+    }
+
+    pair<int, int> pop() {
+        return items[head++];
+    }
+};
+
+/**
+ * Counting-based propagation engine replacing the AC-3 arc queue. With sudoku's not-equal constraints, a value in a square's
+ * domain only loses support from a peer when that peer's domain shrinks to exactly that value, so support counting (AC-4/AC-2001
+ * style) reduces to tracking which squares became singletons. The engine drains a queue of singleton squares, removes each one's
+ * value from its 20 peers exactly once, and enqueues any peer that becomes a singleton in turn - no arc is ever revisited and no
+ * domain is ever rescanned. Reaches the same fixpoint as the old arc-queue AC-3
+ * Returns false if a domain is wiped out, and true otherwise
+ * @param domains The 9x9 list of domains
+ * @param pending The queue of squares whose domains have become singletons and still need propagating
+ * @param trail The trail recording domain removals
+ */
+inline bool propagateSingletons(Domain domains[9][9], PendingQueue &pending, DomainTrail &trail) {
+    STATS_PROPAGATION_SCOPE();
+    while (!pending.empty()) {
+        auto square = pending.pop();
+        if (domains[square.first][square.second].size() != 1) {
+            continue; // Only singleton domains remove support from their peers
+        }
+        int value = domains[square.first][square.second][0];
+
+        for (int peer : PEERS.peers[square.first * 9 + square.second]) {
+            int peerRow = peer / 9;
+            int peerCol = peer % 9;
+            Domain &peerDomain = domains[peerRow][peerCol];
+            for (int i = 0; i < peerDomain.size(); i++) {
+                if (peerDomain[i] == value) {
+                    trail.record(peerRow, peerCol, value); // Record the removal so it can be rolled back
+                    peerDomain.erase(i);
+                    if (peerDomain.empty()) {
+                        STATS_WIPEOUT(peerRow, peerCol);
+                        return false; // If the domain is empty, there is an inconsistency
+                    }
+                    if (peerDomain.size() == 1) {
+                        pending.push({peerRow, peerCol}); // The peer became a singleton, so its value must be propagated too
+                    }
+                    break; // Each value appears at most once per domain
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Enforces arc consistency on all squares by seeding the propagation engine with every singleton domain and draining it to fixpoint
+ * Removals are recorded on the trail so a failed branch can be rolled back without copying domains
+ * Returns false if an inconsistency is detected, and true otherwise
+ * @param domains The 9x9 list of domains
+ * @param trail The trail recording domain removals
+ */
+inline bool ac3(Domain domains[9][9], DomainTrail &trail) {
+    PendingQueue pending;
+    for (int i = 0; i < 9; i ++) {
+        for (int j = 0; j < 9; j++) {
+            if (domains[i][j].size() == 1) {
+                pending.push({i, j}); // Seed the queue with every square that's already down to one value
+            }
+        }
+    }
+    return propagateSingletons(domains, pending, trail);
+}
+
+/**
+ * Fills squares with single value domains with their value
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains
+ */
+inline void fillSingles(int board[9][9], Domain domains[9][9]) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (board[i][j] == 0 && domains[i][j].size() == 1) {
+                board[i][j] = domains[i][j][0];
+            }
+        }
+    }
+}
+
+/**
+ * Gets the position of the kth square within a unit (one of the 9 rows, then the 9 columns, then the 9 subsquares)
+ * @param unit The unit index (0-8 rows, 9-17 columns, 18-26 subsquares)
+ * @param k The square's index within the unit
+ */
+inline pair<int, int> unitSquare(int unit, int k) {
+    if (unit < 9) {
+        return {unit, k}; // Rows
+    }
+    if (unit < 18) {
+        return {k, unit - 9}; // Columns
+    }
+    return {((unit - 18) / 3) * 3 + k / 3, ((unit - 18) % 3) * 3 + k % 3}; // Subsquares
+}
+
+/**
+ * Fills hidden singles: if a value has exactly one remaining home within a row, column or subsquare, it must go there, even when that square's domain holds other values
+ * Each assignment restricts the square's domain and runs singleton propagation, with all removals recorded on the trail
+ * Returns false if an inconsistency is detected, and true otherwise
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains
+ * @param trail The trail recording domain removals
+ * @param changed Set to true if any square was filled
+ */
+inline bool applyHiddenSingles(int board[9][9], Domain domains[9][9], DomainTrail &trail, bool &changed) {
+    for (int unit = 0; unit < 27; unit++) {
+        for (int value = 1; value <= 9; value++) {
+            int found = 0;
+            int foundRow = -1;
+            int foundCol = -1;
+            bool placed = false;
+            for (int k = 0; k < 9; k++) {
+                pair<int, int> square = unitSquare(unit, k);
+                if (board[square.first][square.second] == value) {
+                    placed = true; // The value is already placed within this unit
+                    break;
+                }
+                for (int v : domains[square.first][square.second]) {
+                    if (v == value) {
+                        found++;
+                        foundRow = square.first;
+                        foundCol = square.second;
+                        break;
+                    }
+                }
+            }
+            if (placed || found != 1 || board[foundRow][foundCol] != 0) {
+                continue; // Only act when the value has exactly one remaining home and it's still empty
+            }
+            for (int v : domains[foundRow][foundCol]) {
+                if (v != value) {
+                    trail.record(foundRow, foundCol, v); // Record the values removed when restricting the domain to the hidden single
+                }
+            }
+            domains[foundRow][foundCol] = {value};
+            board[foundRow][foundCol] = value;
+            changed = true;
+            PendingQueue pending;
+            pending.push({foundRow, foundCol});
+            if (!propagateSingletons(domains, pending, trail)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Applies naked pairs: if two squares within a unit share the same two-value domain, those two values must go in those two squares, so they're removed from every other domain in the unit
+ * Removals are recorded on the trail, and any square reduced to a single value is propagated
+ * Returns false if an inconsistency is detected, and true otherwise
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains
+ * @param trail The trail recording domain removals
+ * @param changed Set to true if any domain was pruned
+ */
+inline bool applyNakedPairs(int board[9][9], Domain domains[9][9], DomainTrail &trail, bool &changed) {
+    for (int unit = 0; unit < 27; unit++) {
+        for (int i = 0; i < 9; i++) {
+            pair<int, int> first = unitSquare(unit, i);
+            if (board[first.first][first.second] != 0 || domains[first.first][first.second].size() != 2) {
+                continue;
+            }
+            for (int j = i + 1; j < 9; j++) {
+                pair<int, int> second = unitSquare(unit, j);
+                Domain &firstDomain = domains[first.first][first.second];
+                Domain &secondDomain = domains[second.first][second.second];
+                if (board[second.first][second.second] != 0 || secondDomain.size() != 2 || firstDomain[0] != secondDomain[0] || firstDomain[1] != secondDomain[1]) {
+                    continue; // Only identical two-value domains form a naked pair
+                }
+                for (int k = 0; k < 9; k++) {
+                    if (k == i || k == j) {
+                        continue;
+                    }
+                    pair<int, int> other = unitSquare(unit, k);
+                    Domain &otherDomain = domains[other.first][other.second];
+                    for (int pos = 0; pos < otherDomain.size();) {
+                        if (otherDomain[pos] == firstDomain[0] || otherDomain[pos] == firstDomain[1]) {
+                            trail.record(other.first, other.second, otherDomain[pos]); // Record the removal so it can be rolled back
+                            otherDomain.erase(pos);
+                            changed = true;
+                        }
+                        else {
+                            pos++;
+                        }
+                    }
+                    if (otherDomain.empty()) {
+                        return false; // If the domain is empty, there is an inconsistency
+                    }
+                    if (otherDomain.size() == 1) {
+                        PendingQueue pending;
+                        pending.push(other);
+                        if (!propagateSingletons(domains, pending, trail)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Runs the human-style propagation rules (hidden singles and naked pairs) to fixpoint before search begins
+ * On easy and medium puzzles this typically fills most or all of the board, so the search starts with few or no empty squares
+ * Returns false if an inconsistency is detected, and true otherwise
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains
+ * @param trail The trail recording domain removals
+ */
+inline bool propagateHumanRules(int board[9][9], Domain domains[9][9], DomainTrail &trail) {
+    bool changed = true;
+    while (changed) { // Each rule can expose new work for the other, so loop until neither changes anything
+        changed = false;
+        if (!applyHiddenSingles(board, domains, trail, changed)) {
+            return false;
+        }
+        if (!applyNakedPairs(board, domains, trail, changed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** 
+ * Iterates through the board, checking for an empty square (represented by 0) and returning its location if found
+ * @param board The 9x9 puzzle board
+*/
+inline pair<int, int> findEmpty(int board[9][9]) {
+    for (int i = 0; i < 9; i++) { // for each row
+        for (int j = 0; j < 9; j++) { // for each column
+            if (board[i][j] == 0) {
+                return {i, j};
+            }
+        }
+    }
+    return {-1, -1}; // return impossible location if none found
+}
+
+/**
+ * Iterates through the board, checking for an empty square (represented by 0) and returning its location if found. Used for MAC solving
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains for each square
+ */
+inline pair<int, int> findEmptyMAC(int board[9][9], Domain domains[9][9]) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (board[i][j] == 0) {
+                return {i, j};
+            }
+        }
+    }
+    return {-1, -1};
+}
+
+/**
+ * Iterates through the board, and uses the Minimum Remaining Value heuristic to determine the next empty square to be filled
+ * The function iterates through empty squares on the board, and returns the position of the one with the least remaining valid values
+ * @param board The 9x9 puzzle board
+ */
+inline pair<int, int> findEmptyMRV(int board[9][9]) {
+    int smallest = 10; // Default best number of possible values +1 for comparisons
+    pair<int, int> square = {-1, -1};
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (board[i][j] != 0) { // Skip filled squares
+                continue;
+            }
+            Domain validNums;
+            findValid(board, i, j, validNums);
+            if (validNums.size() < smallest) {
+                smallest = validNums.size();
+                square = {i, j};
+                if (smallest == 0 || smallest == 1) { // Exit early if a dead end or the lowest possible amount of valid values is found
+                    return square;
+                }
+            }
+        }
+    }
+    return square;
+}
+/**
+ * Iterates through the bitmask board, checking for an empty square (represented by 0) and returning its location if found
+ * @param board The bitmask puzzle board
+ */
+inline pair<int, int> findEmptyMask(MaskBoard &board) {
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (board.cells[i][j] == 0) {
+                return {i, j};
+            }
+        }
+    }
+    return {-1, -1};
+}
+
+/**
+ * Iterates through the bitmask board, and uses the Minimum Remaining Value heuristic to determine the next empty square to be filled
+ * Each square's remaining value count is a single popcount of its candidate mask rather than nine isValid scans
+ * @param board The bitmask puzzle board
+ */
+inline pair<int, int> findEmptyMRVMask(MaskBoard &board) {
+    int smallest = 10; // Default best number of possible values +1 for comparisons
+    pair<int, int> square = {-1, -1};
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (board.cells[i][j] != 0) { // Skip filled squares
+                continue;
+            }
+            int candidateCount = countCandidates(board.candidates(i, j));
+            if (candidateCount < smallest) {
+                smallest = candidateCount;
+                square = {i, j};
+                if (smallest == 0 || smallest == 1) { // Exit early if a dead end or the lowest possible amount of valid values is found
+                    return square;
+                }
+            }
+        }
+    }
+    return square;
+}
+
+/**
+ * Iterates through the board, and uses the Minimum Remaining Value heuristic to determine the next empty square to be filled
+ * The function iterates through empty squares on the board, and returns the position of the one with the smallest domain size
+ * @param board The 9x9 ppuzzle board
+ * @param domains The 9x9 list of domains for each square
+ */
+inline pair<int, int> findEmptyMRVMAC(int board[9][9], Domain domains[9][9]) {
+    int smallest = 10; // Default best number of possible values +1 for comparisons
+    pair<int, int> square = {-1, -1};
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            if (board[i][j] != 0) { // Skip filled squares
+                continue;
+            }
+            int domainSize = domains[i][j].size();
+            if (domainSize < smallest) {
+                smallest = domainSize;
+                square = {i, j};
+                if (smallest == 0 || smallest == 1) { // Exit early if a dead end or the lowest possible amount of valid values is found
+                    return square;
+                }
+            }
+        }
+    }
+    return square;
+}
+
+/**
+ * Checks if placing a value at (row, col) has eliminated all remaining values for any of the square's 20 peers
+ * A placement can only affect squares within its own row, column and subsquare, so no square before the placement had an empty candidate set and only the peers need rechecking
+ * @param board The 9x9 puzzle board
+ * @param row The row of the square that was just filled
+ * @param col The column of the square that was just filled
+ */
+inline bool hasFuturePeers(int board[9][9], int row, int col) {
+    for (int peer : PEERS.peers[row * 9 + col]) {
+        int peerRow = peer / 9;
+        int peerCol = peer % 9;
+        if (board[peerRow][peerCol] != 0) {
+            continue;
+        }
+        bool anyVal = false;
+        for (int v = 1; v < 10; v++) {
+            if (isValid(board, peerRow, peerCol, v)) {
+                anyVal = true;
+                break;
+            }
+        }
+        if (anyVal == false) {
+            STATS_WIPEOUT(peerRow, peerCol);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks if placing a value at (row, col) on the bitmask board has eliminated all remaining values for any of the square's 20 peers
+ * Each peer's check is a single candidate mask read, so wipeout detection costs 20 mask reads per placement instead of a full board rescan
+ * @param board The bitmask puzzle board
+ * @param row The row of the square that was just filled
+ * @param col The column of the square that was just filled
+ */
+inline bool hasFutureMaskPeers(MaskBoard &board, int row, int col) {
+    for (int peer : PEERS.peers[row * 9 + col]) {
+        int peerRow = peer / 9;
+        int peerCol = peer % 9;
+        if (board.cells[peerRow][peerCol] == 0 && board.candidates(peerRow, peerCol) == 0) {
+            STATS_WIPEOUT(peerRow, peerCol);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Tracks the solutions found during a counting search, which keeps searching past the first solution up to a limit
+ * Proving a generated puzzle unique only needs a limit of 2, and the search stops the moment the limit is reached,
+ * so a uniqueness check costs barely more than a single solve
+ * @param count The number of solutions found so far
+ * @param limit Stop searching once this many solutions have been found
+ * @param firstBoard A copy of the first solution found (later ones are destroyed as the search backtracks through them)
+ */
+struct SolutionCounter {
+    int count = 0;
+    int limit = 2;
+    int firstBoard[9][9] = {};
+
+    /**
+     * Records a full solution, keeping a copy of the first one
+     * Returns true once the limit is reached and the search should stop
+     * @param board The solved 9x9 board
+     */
+    bool found(int board[9][9]) {
+        if (count == 0) {
+            for (int r = 0; r < 9; r++) {
+                for (int c = 0; c < 9; c++) {
+                    firstBoard[r][c] = board[r][c];
+                }
+            }
+        }
+        count++;
+        return count >= limit;
+    }
+};
+
+/**
+ * Recursively solves the sudoku using backtracking with pruning, by recursively checking each valid value within each square and backtracking if none exist.
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The 9x9 puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(int[9][9]), void (*ValidNumFinder)(int[9][9], int, int, Domain&)>
+bool pruning(int board[9][9], int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(board, row, col, validNums);
+
+    for (int i=0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board[row][col] = validNums[i];
+        if (pruning<NextEmpty, ValidNumFinder>(board, steps, backtracks, stop, counter)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            STATS_BACKTRACK();
+            board[row][col] = 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * Recursively solves the sudoku using backtracking with forward checking, by placing a valid value within a square then checking if doing so elimates all valid values for any other squares
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The 9x9 puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(int[9][9]), void (*ValidNumFinder)(int[9][9], int, int, Domain&)>
+bool forwardChecking(int board[9][9], int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(board, row, col, validNums);
+
+    for(int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board[row][col] = validNums[i];
+        if (!hasFuturePeers(board, row, col)) { // If placing a value into this square eliminates all possible values for any other square, backtrack
+            board[row][col] = 0;
+            backtracks++;
+            STATS_BACKTRACK();
+            continue;
+        }
+        if (forwardChecking<NextEmpty, ValidNumFinder>(board, steps, backtracks, stop, counter)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            STATS_BACKTRACK();
+            board[row][col] = 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * Recursively solves the sudoku using backtracking with pruning on the bitmask board engine, updating the used-value masks incrementally on each placement and removal
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The bitmask puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(MaskBoard&), void (*ValidNumFinder)(MaskBoard&, int, int, Domain&)>
+bool pruningMask(MaskBoard &board, int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board.cells); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(board, row, col, validNums);
+
+    for (int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board.place(row, col, validNums[i]);
+        if (pruningMask<NextEmpty, ValidNumFinder>(board, steps, backtracks, stop, counter)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            STATS_BACKTRACK();
+            board.unplace(row, col);
+        }
+    }
+    return false;
+}
+
+/**
+ * Recursively solves the sudoku using backtracking with forward checking on the bitmask board engine, placing a valid value then checking if doing so eliminates all candidates for any other square
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The bitmask puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(MaskBoard&), void (*ValidNumFinder)(MaskBoard&, int, int, Domain&)>
+bool forwardCheckingMask(MaskBoard &board, int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board.cells); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(board, row, col, validNums);
+
+    for (int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board.place(row, col, validNums[i]);
+        if (!hasFutureMaskPeers(board, row, col)) { // If placing a value into this square eliminates all possible values for any other square, backtrack
+            board.unplace(row, col);
+            backtracks++;
+            STATS_BACKTRACK();
+            continue;
+        }
+        if (forwardCheckingMask<NextEmpty, ValidNumFinder>(board, steps, backtracks, stop, counter)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            STATS_BACKTRACK();
+            board.unplace(row, col);
+        }
+    }
+    return false;
+}
+
+/**
+ * Board engine layering cached MRV bookkeeping over the bitmask board: every empty square's candidate count is kept up to date
+ * incrementally (a placement only changes the counts of its 20 peers), and the squares are kept in count buckets as intrusive
+ * doubly linked lists, so selecting the most constrained square is a scan of at most 10 bucket heads instead of 81 candidate recounts
+ * An occupied bucket 0 also doubles as the forward checking wipeout test, since it means some empty square has no candidates left
+ * @param mask The underlying bitmask board
+ * @param counts The cached candidate count for each empty square, -1 for filled squares
+ * @param bucketHead The first square of each count's bucket list, -1 when the bucket is empty
+ * @param bucketNext The next square in the same bucket, -1 at the end of the list
+ * @param bucketPrev The previous square in the same bucket, -1 at the head of the list
+ */
+struct CountedBoard {
+    MaskBoard mask;
+    int counts[81];
+    int bucketHead[10];
+    int bucketNext[81];
+    int bucketPrev[81];
+
+    /**
+     * Loads an existing 9x9 board into the engine, building the masks and the initial counts and buckets
+     * @param board The 9x9 puzzle board being loaded
+     */
+    void load(int board[9][9]) {
+        mask.load(board);
+        for (int count = 0; count < 10; count++) {
+            bucketHead[count] = -1;
+        }
+        for (int square = 0; square < 81; square++) {
+            counts[square] = -1;
+            if (mask.cells[square / 9][square % 9] == 0) {
+                pushBucket(square, countCandidates(mask.candidates(square / 9, square % 9)));
+            }
+        }
+    }
+
+    /**
+     * Adds an empty square to the front of its count's bucket list
+     * @param square The flat index of the square
+     * @param count The square's candidate count
+     */
+    void pushBucket(int square, int count) {
+        counts[square] = count;
+        bucketNext[square] = bucketHead[count];
+        bucketPrev[square] = -1;
+        if (bucketHead[count] != -1) {
+            bucketPrev[bucketHead[count]] = square;
+        }
+        bucketHead[count] = square;
+    }
+
+    /**
+     * Unlinks a square from its current bucket list
+     * @param square The flat index of the square
+     */
+    void removeBucket(int square) {
+        if (bucketPrev[square] != -1) {
+            bucketNext[bucketPrev[square]] = bucketNext[square];
+        }
+        else {
+            bucketHead[counts[square]] = bucketNext[square];
+        }
+        if (bucketNext[square] != -1) {
+            bucketPrev[bucketNext[square]] = bucketPrev[square];
+        }
+        counts[square] = -1;
+    }
+
+    /**
+     * Recounts an empty peer's candidates after a placement or removal, moving it between buckets if the count changed
+     * @param square The flat index of the peer square
+     */
+    void recount(int square) {
+        int count = countCandidates(mask.candidates(square / 9, square % 9));
+        if (count != counts[square]) {
+            removeBucket(square);
+            pushBucket(square, count);
+        }
+    }
+
+    /**
+     * Places a value into a square, updating the masks and the cached counts of the square's 20 peers
+     * @param row The row of the square
+     * @param col The column of the square
+     * @param value The value being placed
+     */
+    void place(int row, int col, int value) {
+        removeBucket(row * 9 + col); // The square is no longer empty, so it leaves the buckets
+        mask.place(row, col, value);
+        for (int peer : PEERS.peers[row * 9 + col]) {
+            if (mask.cells[peer / 9][peer % 9] == 0) {
+                recount(peer);
+            }
+        }
+    }
+
+    /**
+     * Removes a square's value, updating the masks and the cached counts of the square's 20 peers, used when backtracking
+     * @param row The row of the square
+     * @param col The column of the square
+     */
+    void unplace(int row, int col) {
+        mask.unplace(row, col);
+        pushBucket(row * 9 + col, countCandidates(mask.candidates(row, col))); // The square is empty again, so it rejoins the buckets
+        for (int peer : PEERS.peers[row * 9 + col]) {
+            if (mask.cells[peer / 9][peer % 9] == 0) {
+                recount(peer);
+            }
+        }
+    }
+};
+
+/**
+ * Finds the empty square with the fewest candidate values by scanning the bucket heads from the lowest count upwards, or (-1, -1) if none remain
+ * The earliest square in the first occupied bucket is chosen, keeping the row-major tie-break of the scanning MRV selectors,
+ * so selection walks one bucket's list instead of recounting all 81 squares
+ * @param board The counted puzzle board
+ */
+inline pair<int, int> findEmptyCounted(CountedBoard &board) {
+    for (int count = 0; count < 10; count++) {
+        int best = -1;
+        for (int square = board.bucketHead[count]; square != -1; square = board.bucketNext[square]) {
+            if (best == -1 || square < best) {
+                best = square; // Take the earliest square in the bucket, matching the scanning selectors' tie-break
+            }
+        }
+        if (best != -1) {
+            return {best / 9, best % 9};
+        }
+    }
+    return {-1, -1};
+}
+
+/**
+ * Finds all valid values for a given square on the counted board, in ascending order
+ * @param board The counted puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums The list the valid values are placed into
+ */
+inline void findValidCounted(CountedBoard &board, int row, int col, Domain &validNums) {
+    findValidMask(board.mask, row, col, validNums);
+}
+
+/**
+ * Finds all valid values for a given square on the counted board, ordered by how many candidates each value would remove from the square's peers (LCV)
+ * @param board The counted puzzle board
+ * @param row The row of the square being checked
+ * @param col The column of the square being checked
+ * @param validNums The list the valid values are placed into
+ */
+inline void findValidLCVCounted(CountedBoard &board, int row, int col, Domain &validNums) {
+    findValidLCVMask(board.mask, row, col, validNums);
+}
+
+/**
+ * Recursively solves the sudoku using backtracking with pruning on the counted board engine, selecting squares through the cached count buckets
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The counted puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(CountedBoard&), void (*ValidNumFinder)(CountedBoard&, int, int, Domain&)>
+bool pruningCounted(CountedBoard &board, int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board.mask.cells); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(board, row, col, validNums);
+
+    for (int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board.place(row, col, validNums[i]);
+        if (pruningCounted<NextEmpty, ValidNumFinder>(board, steps, backtracks, stop, counter)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            STATS_BACKTRACK();
+            board.unplace(row, col);
+        }
+    }
+    return false;
+}
+
+/**
+ * Recursively solves the sudoku using backtracking with forward checking on the counted board engine
+ * The wipeout test is a single read: a non-empty count 0 bucket means some empty square just lost its last candidate
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The counted puzzle board
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(CountedBoard&), void (*ValidNumFinder)(CountedBoard&, int, int, Domain&)>
+bool forwardCheckingCounted(CountedBoard &board, int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board.mask.cells); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(board, row, col, validNums);
+
+    for (int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
+        board.place(row, col, validNums[i]);
+        if (board.bucketHead[0] != -1) { // If placing a value into this square eliminates all possible values for any other square, backtrack
+            board.unplace(row, col);
+            backtracks++;
+            STATS_BACKTRACK();
+            continue;
+        }
+        if (forwardCheckingCounted<NextEmpty, ValidNumFinder>(board, steps, backtracks, stop, counter)) {
+            return true;
+        }
+        else {
+            backtracks++;
+            STATS_BACKTRACK();
+            board.unplace(row, col);
+        }
+    }
+    return false;
+}
+
+/**
+ * Recursively solves the sudoku using backtracking with pruning and MAC, by placing a valid value within a square
+ * The algorithm then checks all related squares domains to detect if all values have been eliminated, and prunes the path if so
+ * Domains are updated in place, with every removal recorded on the trail and rolled back on backtrack, instead of deep copying all 81 domains per value trial
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains for each square
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param trail The trail recording domain removals, shared across the whole search
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(int[9][9], Domain[9][9]), void (*ValidNumFinder)(Domain[9][9], int, int, Domain&)>
+bool pruningMAC(int board[9][9], Domain domains[9][9], int &steps, int &backtracks, DomainTrail &trail, atomic<bool> *stop, SolutionCounter *counter) {
+    if (stop != nullptr && stop->load(memory_order_relaxed)) {
+        return false; // The race has already been won elsewhere, so abandon this search
+    }
+    pair<int, int> emptysquare = NextEmpty(board, domains);
+    if (emptysquare == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+    steps++;
+    STATS_NODE_SCOPE();
+
+    Domain validNums;
+    ValidNumFinder(domains, row, col, validNums);
+
+    for(int i = 0; i < validNums.size(); i++) {
+        int mark = trail.mark(); // Everything recorded past this point belongs to this value trial
+        board[row][col] = validNums[i];
+        for (int v : domains[row][col]) {
+            if (v != validNums[i]) {
+                trail.record(row, col, v); // Record the values removed when restricting the domain to the placed value
+            }
+        }
+        domains[row][col] = {validNums[i]};
+
+        PendingQueue pending;
+        pending.push({row, col}); // The domains were already consistent before this placement, so only the new singleton needs propagating
+        if (propagateSingletons(domains, pending, trail)) {
+            if (pruningMAC<NextEmpty, ValidNumFinder>(board, domains, steps, backtracks, trail, stop, counter)) {
+                return true;
+            }
+        }
+        backtracks++;
+        STATS_BACKTRACK();
+        board[row][col] = 0;
+        trail.undoTo(mark, domains); // Roll back every removal from this value trial
+    }
+    return false;
+}
+
+/**
+ * One frame of the iterative engine's explicit search stack, holding everything a recursive call would have kept on the machine stack
+ * @param row The row of the square this frame is filling
+ * @param col The column of the square this frame is filling
+ * @param valueIndex The index into validNums of the value currently being tried
+ * @param mark The trail position taken before the current value trial, for rolling its propagation back
+ * @param validNums The valid values for the square, in the order they are tried
+ */
+struct SearchFrame {
+    int row;
+    int col;
+    int valueIndex;
+    int mark;
+    Domain validNums;
+};
+
+/**
+ * Iterative counterpart of pruningMAC: the same search order and propagation, but with an explicit preallocated frame stack
+ * instead of recursion, so all search state lives in one contiguous array (at most 81 frames) rather than spread across
+ * machine stack frames - better locality on deep searches, and the explicit state is what pause/resume needs
+ * Returns true once the board is solved, and returns false if the board is unsolvable.
+ * The empty square finder and value ordering heuristic are template parameters, so each configuration compiles to a fully specialized, inlinable instantiation with no type-erased call overhead
+ * @param board The 9x9 puzzle board
+ * @param domains The 9x9 list of domains for each square
+ * @param steps The running total of steps used to solve the puzzle
+ * @param backtracks The running total of backtracks used when solving the puzzle
+ * @param trail The trail recording domain removals, shared across the whole search
+ * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+ * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+*/
+template<pair<int, int> (*NextEmpty)(int[9][9], Domain[9][9]), void (*ValidNumFinder)(Domain[9][9], int, int, Domain&)>
+bool solveIterative(int board[9][9], Domain domains[9][9], int &steps, int &backtracks, DomainTrail &trail, atomic<bool> *stop, SolutionCounter *counter) {
+    pair<int, int> first = NextEmpty(board, domains);
+    if (first == make_pair(-1, -1)) {
+        if (counter != nullptr) {
+            return counter->found(board); // In count mode, keep searching until the solution limit is reached
+        }
+        return true; // If no empty squares remain, assume the board to be solved
+    }
+
+    SearchFrame frames[81]; // The whole search fits in 81 preallocated frames, one per square that can still be filled
+    int depth = 0;
+    frames[0].row = first.first;
+    frames[0].col = first.second;
+    frames[0].valueIndex = 0;
+    ValidNumFinder(domains, first.first, first.second, frames[0].validNums);
+    steps++;
+#ifdef SUDOKU_INSTRUMENT
+    searchStats.totalNodes++;
+    searchStats.nodesAtDepth[1]++;
+    searchStats.depth = 1; // Track the engine's depth by hand, where the recursive solvers' node scopes do it for them
+#endif
+
+    while (true) {
+        if (stop != nullptr && stop->load(memory_order_relaxed)) {
+            return false; // The race has already been won elsewhere, so abandon this search
+        }
+#ifdef SUDOKU_INSTRUMENT
+        if (!statsCheckBudget()) {
+            return false; // Node or time budget exhausted, so abandon the search and report partial stats
+        }
+#endif
+        SearchFrame &frame = frames[depth];
+        bool descended = false;
+        while (frame.valueIndex < frame.validNums.size()) {
+            int value = frame.validNums[frame.valueIndex];
+            frame.mark = trail.mark(); // Everything recorded past this point belongs to this value trial
+            board[frame.row][frame.col] = value;
+            for (int v : domains[frame.row][frame.col]) {
+                if (v != value) {
+                    trail.record(frame.row, frame.col, v); // Record the values removed when restricting the domain to the placed value
+                }
+            }
+            domains[frame.row][frame.col] = {value};
+
+            PendingQueue pending;
+            pending.push({frame.row, frame.col}); // The domains were already consistent before this placement, so only the new singleton needs propagating
+            if (propagateSingletons(domains, pending, trail)) {
+                pair<int, int> next = NextEmpty(board, domains);
+                if (next == make_pair(-1, -1)) {
+                    if (counter == nullptr || counter->found(board)) {
+                        return true;
+                    }
+                    board[frame.row][frame.col] = 0; // In count mode, undo the solution and keep trying this frame's later values
+                    trail.undoTo(frame.mark, domains);
+                    backtracks++;
+                    STATS_BACKTRACK();
+                    frame.valueIndex++;
+                    continue;
+                }
+                depth++; // Descend by pushing a frame for the next square, where a recursive engine would call itself
+                frames[depth].row = next.first;
+                frames[depth].col = next.second;
+                frames[depth].valueIndex = 0;
+                ValidNumFinder(domains, next.first, next.second, frames[depth].validNums);
+                steps++;
+#ifdef SUDOKU_INSTRUMENT
+                searchStats.totalNodes++;
+                if (depth + 1 < 82) {
+                    searchStats.nodesAtDepth[depth + 1]++;
+                }
+                searchStats.depth = depth + 1;
+#endif
+                descended = true;
+                break;
+            }
+            board[frame.row][frame.col] = 0; // Propagation wiped out a domain, so roll this value trial back and try the next
+            trail.undoTo(frame.mark, domains);
+            backtracks++;
+            STATS_BACKTRACK();
+            frame.valueIndex++;
+        }
+        if (descended) {
+            continue;
+        }
+        if (depth == 0) {
+            return false; // Every value of the first square failed, so the search is exhausted
+        }
+        depth--; // Backtrack by popping to the parent frame, undoing the value it was trying
+#ifdef SUDOKU_INSTRUMENT
+        searchStats.depth = depth + 1; // The pop returns to the parent's depth, so its backtrack is recorded there
+#endif
+        SearchFrame &parent = frames[depth];
+        board[parent.row][parent.col] = 0;
+        trail.undoTo(parent.mark, domains);
+        backtracks++;
+        STATS_BACKTRACK();
+        parent.valueIndex++;
+    }
+}
+
+/**
+ * The complete state of an iterative engine search: the board, the domains, the trail and the explicit frame stack, plus the
+ * running totals. Because the iterative engine keeps everything a recursive call would have hidden on the machine stack in here,
+ * this is all a solve needs to pause and later resume exactly where it left off, and it serializes to a compact binary snapshot
+ * @param board The 9x9 puzzle board, including the values placed along the current search path
+ * @param domains The 9x9 list of domains for each square
+ * @param trail The trail of domain removals made since the solve began, including the AC-3 preprocessing
+ * @param frames The explicit search stack, valid up to depth once the search has started
+ * @param depth The index of the deepest open frame
+ * @param steps The steps searched so far, carried across resumes
+ * @param backtracks The backtracks performed so far, carried across resumes
+ * @param started Whether the root frame has been opened yet
+ * @param emptyFinder The empty square heuristic the search was started with, so a resume dispatches to the same instantiation
+ * @param valueOrder The value ordering heuristic the search was started with
+ */
+struct IterativeState {
+    int board[9][9];
+    Domain domains[9][9];
+    DomainTrail trail;
+    SearchFrame frames[81];
+    int depth = 0;
+    int steps = 0;
+    int backtracks = 0;
+    bool started = false;
+    int emptyFinder = 1;
+    int valueOrder = 1;
+
+    /**
+     * Appends a 4 byte little endian integer to the snapshot bytes
+     * @param out The snapshot bytes being built
+     * @param value The integer being appended
+     */
+    static void putInt(string &out, int value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back((char)((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    /**
+     * Reads a 4 byte little endian integer from the snapshot bytes, returning false if the bytes run out
+     * @param in The snapshot bytes being read
+     * @param pos The current read position, advanced past the integer
+     * @param value The integer read out
+     */
+    static bool getInt(const string &in, size_t &pos, int &value) {
+        if (pos + 4 > in.size()) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= ((int)(unsigned char)in[pos + i]) << (8 * i);
+        }
+        pos += 4;
+        return true;
+    }
+
+    /**
+     * Serializes the whole search state to a compact binary snapshot: a few bytes per square, removal and open frame
+     */
+    string serialize() const {
+        string out = "SDKP1"; // Magic and format version, checked on restore
+        putInt(out, emptyFinder);
+        putInt(out, valueOrder);
+        putInt(out, steps);
+        putInt(out, backtracks);
+        putInt(out, depth);
+        out.push_back(started ? 1 : 0);
+        for (int square = 0; square < 81; square++) {
+            out.push_back((char)board[square / 9][square % 9]);
+        }
+        for (int square = 0; square < 81; square++) {
+            const Domain &domain = domains[square / 9][square % 9];
+            out.push_back((char)domain.size());
+            for (int i = 0; i < domain.size(); i++) {
+                out.push_back((char)domain[i]);
+            }
+        }
+        putInt(out, trail.removals.size());
+        for (int i = 0; i < (int)trail.removals.size(); i++) {
+            out.push_back((char)trail.removals[i].first.first);
+            out.push_back((char)trail.removals[i].first.second);
+            out.push_back((char)trail.removals[i].second);
+        }
+        if (started) {
+            for (int f = 0; f <= depth; f++) {
+                out.push_back((char)frames[f].row);
+                out.push_back((char)frames[f].col);
+                out.push_back((char)frames[f].valueIndex);
+                putInt(out, frames[f].mark);
+                out.push_back((char)frames[f].validNums.size());
+                for (int i = 0; i < frames[f].validNums.size(); i++) {
+                    out.push_back((char)frames[f].validNums[i]);
+                }
+            }
+        }
+        return out;
+    }
+
+    /**
+     * Restores the search state from a snapshot produced by serialize(), returning false if the bytes are truncated or not a snapshot
+     * @param in The snapshot bytes
+     */
+    bool deserialize(const string &in) {
+        if (in.size() < 5 || in.compare(0, 5, "SDKP1") != 0) {
+            return false;
+        }
+        size_t pos = 5;
+        int startedByte = 0;
+        if (!getInt(in, pos, emptyFinder) || !getInt(in, pos, valueOrder) || !getInt(in, pos, steps) || !getInt(in, pos, backtracks) || !getInt(in, pos, depth)) {
+            return false;
+        }
+        if (emptyFinder < 1 || emptyFinder > 2 || valueOrder < 1 || valueOrder > 2 || steps < 0 || backtracks < 0) {
+            return false; // Every field is range checked, so a corrupted snapshot is rejected here rather than crashing the search
+        }
+        if (pos + 1 + 81 > in.size()) {
+            return false;
+        }
+        startedByte = (unsigned char)in[pos++];
+        started = startedByte != 0;
+        for (int square = 0; square < 81; square++) {
+            board[square / 9][square % 9] = (unsigned char)in[pos++];
+            if (board[square / 9][square % 9] > 9) {
+                return false;
+            }
+        }
+        for (int square = 0; square < 81; square++) {
+            if (pos >= in.size()) {
+                return false;
+            }
+            int count = (unsigned char)in[pos++];
+            if (count > 9 || pos + count > in.size()) {
+                return false;
+            }
+            Domain &domain = domains[square / 9][square % 9];
+            domain.clear();
+            for (int i = 0; i < count; i++) {
+                int value = (unsigned char)in[pos++];
+                if (value < 1 || value > 9) {
+                    return false;
+                }
+                domain.push_back(value);
+            }
+        }
+        int removalCount = 0;
+        if (!getInt(in, pos, removalCount) || removalCount < 0 || pos + (size_t)removalCount * 3 > in.size()) {
+            return false;
+        }
+        trail.removals.clear();
+        for (int i = 0; i < removalCount; i++) {
+            int row = (unsigned char)in[pos++];
+            int col = (unsigned char)in[pos++];
+            int value = (unsigned char)in[pos++];
+            if (row > 8 || col > 8 || value < 1 || value > 9) {
+                return false;
+            }
+            trail.removals.push_back({{row, col}, value});
+        }
+        if (started) {
+            if (depth < 0 || depth >= 81) {
+                return false;
+            }
+            for (int f = 0; f <= depth; f++) {
+                if (pos + 3 > in.size()) {
+                    return false;
+                }
+                frames[f].row = (unsigned char)in[pos++];
+                frames[f].col = (unsigned char)in[pos++];
+                frames[f].valueIndex = (unsigned char)in[pos++];
+                if (frames[f].row > 8 || frames[f].col > 8) {
+                    return false;
+                }
+                if (!getInt(in, pos, frames[f].mark)) {
+                    return false;
+                }
+                if (frames[f].mark < 0 || frames[f].mark > removalCount) {
+                    return false; // A mark past the restored trail would make the next undo walk off its end
+                }
+                if (pos >= in.size()) {
+                    return false;
+                }
+                int count = (unsigned char)in[pos++];
+                if (count > 9 || frames[f].valueIndex > count || pos + count > in.size()) {
+                    return false;
+                }
+                frames[f].validNums.clear();
+                for (int i = 0; i < count; i++) {
+                    int value = (unsigned char)in[pos++];
+                    if (value < 1 || value > 9) {
+                        return false;
+                    }
+                    frames[f].validNums.push_back(value);
+                }
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Controls when a checkpointed search writes its snapshot: periodically every intervalSteps steps, and immediately when the
+ * request flag is set (typically from a signal handler as the host is being preempted), in which case the search saves and stops
+ * so the process can exit with at most an interval's worth of work to replay
+ * @param path The snapshot file the search saves to
+ * @param intervalSteps Save a snapshot every this many steps (0 to save only on request)
+ * @param request Optional flag set externally to ask the search to save and stop at its next step
+ * @param lastSaveSteps The step count at the most recent save, for the interval
+ * @param checkpointed Whether the search stopped early to honour a save request
+ */
+struct CheckpointControl {
+    string path;
+    long long intervalSteps = 0;
+    atomic<bool> *request = nullptr;
+    long long lastSaveSteps = 0;
+    bool checkpointed = false;
+
+    /**
+     * Writes the state's snapshot to the control's path, returning false if the file couldn't be written
+     * @param state The search state being saved
+     */
+    bool save(const IterativeState &state) {
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        string bytes = state.serialize();
+        out.write(bytes.data(), bytes.size());
+        return out.good();
+    }
+};
+
+/**
+ * Checkpointable counterpart of solveIterative: the same search over an IterativeState, pausing to snapshot on interval or request
+ * Returns true once the board is solved, and returns false if the board is unsolvable or the search stopped to save a snapshot
+ * (distinguished by control->checkpointed). Because every mutation lives in the state, a restored snapshot re-enters the loop
+ * exactly where the saved search left it, so preemption costs at most the work done since the last save
+ * @param state The search state, either freshly initialised or restored from a snapshot
+ * @param control Optional checkpoint control deciding when to save the state
+ */
+template<pair<int, int> (*NextEmpty)(int[9][9], Domain[9][9]), void (*ValidNumFinder)(Domain[9][9], int, int, Domain&)>
+bool solveIterativeResumable(IterativeState &state, CheckpointControl *control) {
+    if (!state.started) {
+        pair<int, int> first = NextEmpty(state.board, state.domains);
+        if (first == make_pair(-1, -1)) {
+            return true; // If no empty squares remain, assume the board to be solved
+        }
+        state.depth = 0;
+        state.frames[0].row = first.first;
+        state.frames[0].col = first.second;
+        state.frames[0].valueIndex = 0;
+        ValidNumFinder(state.domains, first.first, first.second, state.frames[0].validNums);
+        state.steps++;
+        state.started = true;
+    }
+
+    while (true) {
+        if (control != nullptr) {
+            if (control->request != nullptr && control->request->load()) {
+                control->request->store(false);
+                control->save(state); // Snapshot and stop, so the process can exit and a later run resumes from here
+                control->checkpointed = true;
+                return false;
+            }
+            if (control->intervalSteps > 0 && state.steps - control->lastSaveSteps >= control->intervalSteps) {
+                control->save(state); // Periodic snapshot, bounding the replay cost if the process dies without warning
+                control->lastSaveSteps = state.steps;
+            }
+        }
+        SearchFrame &frame = state.frames[state.depth];
+        bool descended = false;
+        while (frame.valueIndex < frame.validNums.size()) {
+            int value = frame.validNums[frame.valueIndex];
+            frame.mark = state.trail.mark(); // Everything recorded past this point belongs to this value trial
+            state.board[frame.row][frame.col] = value;
+            for (int v : state.domains[frame.row][frame.col]) {
+                if (v != value) {
+                    state.trail.record(frame.row, frame.col, v); // Record the values removed when restricting the domain to the placed value
+                }
+            }
+            state.domains[frame.row][frame.col] = {value};
+
+            PendingQueue pending;
+            pending.push({frame.row, frame.col}); // The domains were already consistent before this placement, so only the new singleton needs propagating
+            if (propagateSingletons(state.domains, pending, state.trail)) {
+                pair<int, int> next = NextEmpty(state.board, state.domains);
+                if (next == make_pair(-1, -1)) {
+                    return true;
+                }
+                state.depth++; // Descend by pushing a frame for the next square, where a recursive engine would call itself
+                state.frames[state.depth].row = next.first;
+                state.frames[state.depth].col = next.second;
+                state.frames[state.depth].valueIndex = 0;
+                ValidNumFinder(state.domains, next.first, next.second, state.frames[state.depth].validNums);
+                state.steps++;
+                descended = true;
+                break;
+            }
+            state.board[frame.row][frame.col] = 0; // Propagation wiped out a domain, so roll this value trial back and try the next
+            state.trail.undoTo(frame.mark, state.domains);
+            state.backtracks++;
+            frame.valueIndex++;
+        }
+        if (descended) {
+            continue;
+        }
+        if (state.depth == 0) {
+            return false; // Every value of the first square failed, so the search is exhausted
+        }
+        state.depth--; // Backtrack by popping to the parent frame, undoing the value it was trying
+        SearchFrame &parent = state.frames[state.depth];
+        state.board[parent.row][parent.col] = 0;
+        state.trail.undoTo(parent.mark, state.domains);
+        state.backtracks++;
+        parent.valueIndex++;
+    }
+}
+
+/**
+ * Dancing Links (Algorithm X) exact cover engine. The puzzle is encoded as an exact cover matrix with 324 constraint columns
+ * (each cell filled once, each value once per row, column and subsquare) and up to four nodes per candidate placement, stored as
+ * index-linked circular lists. Covering and uncovering a constraint are pointer splices with no domain copying at all, which is
+ * what makes it so fast on sparse, hard boards, and undoing a failed branch is exactly reversing the splices
+ * @param left The left link of each node in its row ring
+ * @param right The right link of each node in its row ring
+ * @param up The up link of each node in its column list
+ * @param down The down link of each node in its column list
+ * @param column The column header each node belongs to
+ * @param candidate The flat placement (row * 81 + col * 9 + value - 1) each row node encodes
+ * @param size The number of candidate rows left in each column
+ * @param picked The candidates selected along the current search path
+ * @param solution The decoded board of the most recent full cover
+ */
+struct DlxSolver {
+    static const int Columns = 324; // 81 cell + 81 row-value + 81 column-value + 81 subsquare-value constraints
+    static const int MaxNodes = 1 + Columns + 729 * 4; // The root, one header per column and four nodes per candidate placement
+
+    int left[MaxNodes];
+    int right[MaxNodes];
+    int up[MaxNodes];
+    int down[MaxNodes];
+    int column[MaxNodes];
+    int candidate[MaxNodes];
+    int size[Columns + 1];
+    int picked[81];
+    int solution[9][9];
+    int nodeCount;
+
+    /**
+     * Links the root and the 324 column headers into an empty matrix
+     */
+    void init() {
+        for (int i = 0; i <= Columns; i++) { // Node 0 is the root and node 1 + k is constraint k's header
+            left[i] = i == 0 ? Columns : i - 1;
+            right[i] = i == Columns ? 0 : i + 1;
+            up[i] = i;
+            down[i] = i;
+            size[i] = 0;
+        }
+        nodeCount = Columns + 1;
+    }
+
+    /**
+     * Adds the candidate row for placing a value at (row, col), linking one node into each of its four constraint columns
+     * @param row The row of the placement
+     * @param col The column of the placement
+     * @param value The value being placed
+     */
+    void addRow(int row, int col, int value) {
+        int box = (row / 3) * 3 + (col / 3);
+        int headers[4] = {
+            1 + row * 9 + col, // The cell is filled
+            1 + 81 + row * 9 + (value - 1), // The value appears in the row
+            1 + 162 + col * 9 + (value - 1), // The value appears in the column
+            1 + 243 + box * 9 + (value - 1), // The value appears in the subsquare
+        };
+        int first = nodeCount;
+        for (int i = 0; i < 4; i++) {
+            int node = nodeCount++;
+            int header = headers[i];
+            up[node] = up[header]; // Link the node to the bottom of its column
+            down[node] = header;
+            down[up[header]] = node;
+            up[header] = node;
+            column[node] = header;
+            size[header]++;
+            candidate[node] = row * 81 + col * 9 + (value - 1);
+            left[node] = i == 0 ? node : node - 1; // Link the four nodes into a ring
+            right[node] = first;
+            if (i != 0) {
+                right[node - 1] = node;
+            }
+        }
+        left[first] = first + 3;
+    }
+
+    /**
+     * Builds the matrix for a board: one candidate row per possible placement, and a single row for each preset square
+     * @param board The 9x9 puzzle board being loaded
+     */
+    void load(int board[9][9]) {
+        init();
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                if (board[r][c] != 0) {
+                    addRow(r, c, board[r][c]); // Preset squares get exactly one candidate, so the search picks them first
+                }
+                else {
+                    for (int v = 1; v <= 9; v++) {
+                        addRow(r, c, v);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Covers a constraint column: unlinks its header and removes every row using it from the other columns, all by pointer splices
+     * @param header The column's header node
+     */
+    void cover(int header) {
+        right[left[header]] = right[header];
+        left[right[header]] = left[header];
+        for (int row = down[header]; row != header; row = down[row]) {
+            for (int node = right[row]; node != row; node = right[node]) {
+                down[up[node]] = down[node];
+                up[down[node]] = up[node];
+                size[column[node]]--;
+            }
+        }
+    }
+
+    /**
+     * Uncovers a constraint column, exactly reversing cover()'s splices to restore the matrix
+     * @param header The column's header node
+     */
+    void uncover(int header) {
+        for (int row = up[header]; row != header; row = up[row]) {
+            for (int node = left[row]; node != row; node = left[node]) {
+                size[column[node]]++;
+                down[up[node]] = node;
+                up[down[node]] = node;
+            }
+        }
+        right[left[header]] = header;
+        left[right[header]] = header;
+    }
+
+    /**
+     * Decodes the candidates picked along the current search path into the solution board
+     * @param depth The number of candidates picked
+     */
+    void decode(int depth) {
+        for (int i = 0; i < depth; i++) {
+            solution[picked[i] / 81][(picked[i] / 9) % 9] = picked[i] % 9 + 1;
+        }
+    }
+
+    /**
+     * Recursively searches for an exact cover: picks the constraint with the fewest candidates, tries each of its rows, and backtracks by uncovering
+     * Returns true once a full cover (a solved board) is reached, and false if none exists down this branch
+     * @param depth The number of candidates picked so far
+     * @param steps The running total of steps used to solve the puzzle
+     * @param backtracks The running total of backtracks used when solving the puzzle
+     * @param stop Optional shared stop flag. When another thread sets it, the search unwinds and returns unsolved
+     * @param counter Optional solution counter. When set, the search continues past each solution until the counter's limit is reached
+     */
+    bool search(int depth, int &steps, int &backtracks, atomic<bool> *stop, SolutionCounter *counter) {
+        if (stop != nullptr && stop->load(memory_order_relaxed)) {
+            return false; // The race has already been won elsewhere, so abandon this search
+        }
+        if (right[0] == 0) { // Every constraint is covered, so the picked candidates form a solved board
+            decode(depth);
+            if (counter != nullptr) {
+                return counter->found(solution); // In count mode, keep searching until the solution limit is reached
+            }
+            return true;
+        }
+        steps++;
+        STATS_NODE_SCOPE();
+
+        int best = right[0];
+        for (int header = right[best]; header != 0; header = right[header]) {
+            if (size[header] < size[best]) {
+                best = header; // Pick the constraint with the fewest candidates left, the matrix equivalent of MRV
+            }
+        }
+
+        cover(best);
+        for (int row = down[best]; row != best; row = down[row]) {
+            picked[depth] = candidate[row];
+            for (int node = right[row]; node != row; node = right[node]) {
+                cover(column[node]);
+            }
+            if (search(depth + 1, steps, backtracks, stop, counter)) {
+                for (int node = left[row]; node != row; node = left[node]) {
+                    uncover(column[node]); // Unwind cleanly even on success, so the matrix is restored
+                }
+                uncover(best);
+                return true;
+            }
+            backtracks++;
+            STATS_BACKTRACK();
+            for (int node = left[row]; node != row; node = left[node]) {
+                uncover(column[node]);
+            }
+        }
+        uncover(best);
+        return false;
+    }
+};
+
+/**
+ * Bounded LRU cache of solved boards, keyed on the canonical 81 character form of the starting board
+ * Workloads with heavy duplication (retries, mirrored sources) turn repeat solves into lookups instead of full searches
+ * The cache is guarded by a mutex, so batch workers can safely share one
+ * @param entries The cached solves, most recently used at the front
+ * @param index Lookup from board key to its entry in the list
+ * @param capacity The maximum number of boards kept before the least recently used is evicted
+ * @param hits The number of lookups answered from the cache
+ * @param misses The number of lookups that fell through to a full solve
+ */
+struct SolutionCache {
+    /**
+     * One cached solve: the solved board (in the key's digit labels) and the metrics of the search that produced it
+     */
+    struct Entry {
+        string key;
+        int board[9][9];
+        bool solved;
+        int steps;
+        int backtracks;
+    };
+
+    list<Entry> entries;
+    unordered_map<string, list<Entry>::iterator> index;
+    int capacity = 1024;
+    long long hits = 0;
+    long long misses = 0;
+    mutex lock;
+
+    /**
+     * Looks a board key up, copying its entry out and marking it most recently used
+     * Returns true on a hit and false on a miss, counting either way
+     * @param key The canonical board key
+     * @param out Pointer to the entry the cached solve is copied into
+     */
+    bool get(const string &key, Entry &out) {
+        lock_guard<mutex> guard(lock);
+        auto found = index.find(key);
+        if (found == index.end()) {
+            misses++;
+            return false;
+        }
+        entries.splice(entries.begin(), entries, found->second); // Move the entry to the front, as it's now the most recently used
+        hits++;
+        out = *found->second;
+        return true;
+    }
+
+    /**
+     * Stores a solve under its board key, evicting the least recently used entry once over capacity
+     * @param entry The entry being stored, including its key
+     */
+    void put(const Entry &entry) {
+        lock_guard<mutex> guard(lock);
+        auto found = index.find(entry.key);
+        if (found != index.end()) {
+            entries.splice(entries.begin(), entries, found->second); // Another worker already stored this board, just refresh it
+            *found->second = entry;
+            return;
+        }
+        entries.push_front(entry);
+        index[entry.key] = entries.begin();
+        if ((int)entries.size() > capacity) {
+            index.erase(entries.back().key); // Evict the least recently used entry from the back
+            entries.pop_back();
+        }
+    }
+};
+
+/**
+ * Builds a board's canonical cache key: its 81 squares as characters, row by row
+ * When normalizing, digits are relabeled in first-appearance order, so boards identical up to a digit permutation share a key,
+ * and the permutation is returned so a cached solution can be translated back into the board's own labels
+ * @param board The 9x9 puzzle board
+ * @param normalize Whether to normalize under digit relabeling
+ * @param relabel The 10 entry digit permutation used (identity when not normalizing), indexed by original digit
+ */
+inline string cacheKey(int board[9][9], bool normalize, int relabel[10]) {
+    for (int d = 0; d < 10; d++) {
+        relabel[d] = normalize ? 0 : d;
+    }
+    if (normalize) {
+        int next = 1;
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                int d = board[r][c];
+                if (d != 0 && relabel[d] == 0) {
+                    relabel[d] = next++; // Digits are labeled 1.. in the order they first appear
+                }
+            }
+        }
+        for (int d = 1; d < 10; d++) {
+            if (relabel[d] == 0) {
+                relabel[d] = next++; // Digits absent from the puzzle still need labels, for translating the solution back
+            }
+        }
+    }
+
+    string key(81, '0');
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            key[r * 9 + c] = (char)('0' + relabel[board[r][c]]);
+        }
+    }
+    return key;
+}
+
+/**
+ * Stores the outcome of a solver run, including the final board state and metrics
+ * @param board The 9x9 solved (or attempted) puzzle board
+ * @param solved Whether the solver found a valid solution
+ * @param steps The total number of recursion steps performed
+ * @param backtracks The total number of backtracks performed
+ * @param runtime The elapsed solving time in microseconds
+ * @param solutions The number of solutions found (at most 1 unless a count limit was set)
+ * @param cacheHit Whether this solve was answered from the solution cache
+ * @param cacheHits The cache's running hit count, when a cache is attached
+ * @param cacheMisses The cache's running miss count, when a cache is attached
+ */
+struct SolveResult {
+    int board[9][9];
+    bool solved;
+    int steps;
+    int backtracks;
+    long long runtime;
+    int solutions;
+    bool cacheHit;
+    long long cacheHits;
+    long long cacheMisses;
+};
+
+/**
+ * Stores a full solver configuration, so a solve can be run without per-puzzle prompts (used by the batch mode and comparison)
+ * @param method Selected option for solving method
+ * @param emptyFinder Selected option for empty finding heuristic
+ * @param valueOrder Selected option for value ordering heuristic
+ * @param engine Selected option for the board engine
+ * @param useAC3 Selected option for whether or not to use AC-3 preprocessing
+ * @param useRules Selected option for whether or not to run hidden singles and naked pairs propagation before search
+ * @param stop Optional shared stop flag checked during the search, used to cancel a solve from another thread (null to never cancel)
+ * @param nodeBudget Abort the solve after this many search nodes, 0 for unlimited (instrumented builds only)
+ * @param timeBudgetUs Abort the solve after this much search time in microseconds, 0 for unlimited (instrumented builds only)
+ * @param countLimit Keep searching past the first solution up to this many (1 for a normal solve, 2 to prove uniqueness)
+ * @param cache Optional solution cache consulted before searching and filled after (null for no caching)
+ * @param cacheNormalize Selected option for whether to normalize cache keys under digit relabeling, so relabeled boards share entries
+ */
+struct SolverConfig {
+    int method = 1;
+    int emptyFinder = 1;
+    int valueOrder = 1;
+    int engine = 1;
+    int useAC3 = 2;
+    int useRules = 2;
+    atomic<bool> *stop = nullptr;
+    long long nodeBudget = 0;
+    long long timeBudgetUs = 0;
+    int countLimit = 1;
+    SolutionCache *cache = nullptr;
+    int cacheNormalize = 2;
+};
+
+/**
+ * Solves a given sudoku board using an already-chosen configuration, with no user prompts
+ * The function returns a SolveResult, containing the details of the performed solve
+ * @param board The 9x9 puzzle board
+ * @param config The solver configuration to run
+ */
+/**
+ * Cheap features of a board's search root, extracted before committing to a configuration
+ * One AC-3 pass costs a few microseconds, orders of magnitude less than picking the wrong solver for a hard board
+ * @param clues The number of filled squares in the starting board
+ * @param undecided The number of squares left with more than one candidate after AC-3
+ * @param averageDomain The mean domain size across the undecided squares (1 when none remain)
+ * @param maxDomain The largest domain size after AC-3
+ * @param consistent Whether AC-3 completed without wiping out a domain
+ */
+struct RootFeatures {
+    int clues;
+    int undecided;
+    double averageDomain;
+    int maxDomain;
+    bool consistent;
+};
+
+/**
+ * Extracts the root features of a board: the clue count and the post-AC-3 domain size distribution
+ * @param board The 9x9 puzzle board
+ */
+inline RootFeatures extractRootFeatures(int board[9][9]) {
+    RootFeatures features{};
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            if (board[r][c] != 0) {
+                features.clues++;
+            }
+        }
+    }
+    Domain domains[9][9];
+    DomainTrail trail;
+    initDomains(board, domains);
+    features.consistent = ac3(domains, trail);
+    long long totalDomain = 0;
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            if (board[r][c] != 0 || domains[r][c].size() <= 1) {
+                continue; // Filled squares and singletons are already decided
+            }
+            features.undecided++;
+            totalDomain += domains[r][c].size();
+            if (domains[r][c].size() > features.maxDomain) {
+                features.maxDomain = domains[r][c].size();
+            }
+        }
+    }
+    features.averageDomain = features.undecided > 0 ? totalDomain / (double)features.undecided : 1.0;
+    return features;
+}
+
+/**
+ * One row of the auto mode's selection table: the configuration to run when the root features fall inside the row's ranges
+ * Rows are checked in order and the first match wins, so earlier rows should be the more specific ones
+ * @param minClues The inclusive lower bound on the clue count
+ * @param maxClues The inclusive upper bound on the clue count
+ * @param maxAverageDomain The rule applies when the post-AC-3 average domain size is at most this
+ * @param method The solve method the rule selects
+ * @param emptyFinder The empty square heuristic the rule selects
+ * @param valueOrder The value ordering heuristic the rule selects
+ * @param engine The board engine the rule selects
+ */
+struct AutoRule {
+    int minClues;
+    int maxClues;
+    double maxAverageDomain;
+    int method;
+    int emptyFinder;
+    int valueOrder;
+    int engine;
+};
+
+// The auto mode's selection table, tuned from benchmark mode runs over the example boards: no single configuration wins everywhere,
+// so easy boards skip the propagation overhead while tight ones get full MAC. Retune by editing the rows against fresh benchmark output
+static const AutoRule AutoRules[] = {
+    {32, 81, 9.0, 1, 2, 1, 2}, // Plenty of clues: plain pruning with MRV on the bitmask engine, propagation would cost more than it saves
+    {0, 81, 2.5, 1, 2, 1, 2},  // AC-3 nearly finished the board, so the leftover search is trivial either way
+    {0, 81, 3.5, 2, 2, 1, 2},  // Mid tightness: forward checking catches dead ends a step earlier than pruning alone
+    {0, 81, 9.0, 3, 2, 2, 1},  // Sparse and tight: full MAC with MRV and LCV, the propagation pays for itself many times over
+};
+
+/**
+ * Rewrites a configuration's method, heuristics and engine from the board's root features using the selection table
+ * Everything else in the configuration (stop flag, budgets, cache, count limit) is left as the caller set it
+ * @param board The 9x9 puzzle board
+ * @param config The configuration being filled in
+ */
+inline void selectAutoConfig(int board[9][9], SolverConfig &config) {
+    RootFeatures features = extractRootFeatures(board);
+    for (const AutoRule &rule : AutoRules) {
+        if (features.clues < rule.minClues || features.clues > rule.maxClues) {
+            continue;
+        }
+        if (features.averageDomain > rule.maxAverageDomain) {
+            continue;
+        }
+        config.method = rule.method;
+        config.emptyFinder = rule.emptyFinder;
+        config.valueOrder = rule.valueOrder;
+        config.engine = rule.engine;
+        return;
+    }
+    config.method = 3; // No row matched (the table's last row should prevent this), so fall back to the safe hard board choice
+    config.emptyFinder = 2;
+    config.valueOrder = 2;
+    config.engine = 1;
+}
+
+inline SolveResult solveWithConfig(int board[9][9], SolverConfig config) {
+#ifdef SUDOKU_INSTRUMENT
+    statsReset(config.nodeBudget, config.timeBudgetUs); // Clear this thread's stats and arm the budgets for this solve
+#endif
+    int relabel[10];
+    string key;
+    if (config.cache != nullptr && config.countLimit < 2) { // Counting searches aren't cached, as entries hold a single solution
+        key = cacheKey(board, config.cacheNormalize == 1, relabel);
+        SolutionCache::Entry entry;
+        if (config.cache->get(key, entry)) {
+            int inverse[10] = {};
+            for (int d = 0; d < 10; d++) {
+                inverse[relabel[d]] = d; // Translate the cached solution back into this board's digit labels
+            }
+            SolveResult result{};
+            for (int r = 0; r < 9; r++)
+                for (int c = 0; c < 9; c++)
+                    result.board[r][c] = entry.solved ? inverse[entry.board[r][c]] : board[r][c];
+            result.solved = entry.solved;
+            result.solutions = entry.solved ? 1 : 0;
+            result.steps = entry.steps;
+            result.backtracks = entry.backtracks;
+            result.cacheHit = true;
+            result.cacheHits = config.cache->hits;
+            result.cacheMisses = config.cache->misses;
+            return result;
+        }
+    }
+    if (config.method == 6) {
+        selectAutoConfig(board, config); // Automatic mode: pick the configuration from the board's root features
+    }
+    bool solved = false;
+    int steps = 0;
+    int backtracks = 0;
+    int method = config.method;
+    int emptyFinder = config.emptyFinder;
+    int valueOrder = config.valueOrder;
+    int useAC3 = config.useAC3;
+    int engine = config.engine;
+
+    Domain domains[9][9];
+    DomainTrail trail; // Shared trail of domain removals, rolled back on backtrack instead of copying domains
+    if(useAC3 == 1 || method == 3 || method == 4) { // If AC-3 preprocessing is enabled or a MAC method was chosen
+        initDomains(board, domains);
+        if (!ac3(domains, trail)) {
+            SolveResult result{}; // AC-3 detected an inconsistency, so the board is unsolvable without searching
+            for (int r = 0; r < 9; r++)
+                for (int c = 0; c < 9; c++)
+                    result.board[r][c] = board[r][c];
+            result.solved = false;
+            return result;
+        }
+        fillSingles(board, domains);
+    }
+
+    if (config.useRules == 1) { // Run the human-style propagation stage to fixpoint before search
+        if (!(useAC3 == 1 || method == 3 || method == 4)) {
+            initDomains(board, domains); // The rules work on domains, so initialise them if AC-3 didn't
+        }
+        if (!propagateHumanRules(board, domains, trail)) {
+            SolveResult result{}; // The rules detected an inconsistency, so the board is unsolvable without searching
+            for (int r = 0; r < 9; r++)
+                for (int c = 0; c < 9; c++)
+                    result.board[r][c] = board[r][c];
+            result.solved = false;
+            return result;
+        }
+        fillSingles(board, domains);
+    }
+
+    MaskBoard maskBoard;
+    if (engine == 2 && method < 3) {
+        maskBoard.load(board); // Build the incremental masks from the (possibly AC-3 preprocessed) board
+    }
+    CountedBoard countedBoard;
+    if (engine == 3 && method < 3) {
+        countedBoard.load(board); // Build the masks plus the cached candidate counts and buckets
+    }
+
+    SolutionCounter solutionCounter;
+    SolutionCounter *counter = nullptr;
+    if (config.countLimit >= 2) {
+        solutionCounter.limit = config.countLimit;
+        counter = &solutionCounter; // Count mode keeps searching past each solution until the limit is reached
+    }
+
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    // Each branch below dispatches once to a fully specialized solver instantiation, so the heuristics inline into the recursion
+    if (engine == 3 && method < 3) { // Counted board engine: square selection always goes through the cached MRV buckets
+        if (method == 1 and valueOrder == 1) {
+            solved = pruningCounted<findEmptyCounted, findValidCounted>(countedBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 1 and valueOrder == 2) {
+            solved = pruningCounted<findEmptyCounted, findValidLCVCounted>(countedBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 2 and valueOrder == 1) {
+            solved = forwardCheckingCounted<findEmptyCounted, findValidCounted>(countedBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 2 and valueOrder == 2) {
+            solved = forwardCheckingCounted<findEmptyCounted, findValidLCVCounted>(countedBoard, steps, backtracks, config.stop, counter);
+        }
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                board[r][c] = countedBoard.mask.cells[r][c]; // Copy the solved cells back to the array board
+            }
+        }
+    }
+    else if (engine == 2 && method < 3) { // Bitmask board engine ladder, mirroring the array board configurations below
+        if (method == 1 and emptyFinder == 1 and valueOrder == 1) {
+            solved = pruningMask<findEmptyMask, findValidMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 1 and emptyFinder == 1 and valueOrder == 2) {
+            solved = pruningMask<findEmptyMask, findValidLCVMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 1 and emptyFinder == 2 and valueOrder == 1) {
+            solved = pruningMask<findEmptyMRVMask, findValidMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 1 and emptyFinder == 2 and valueOrder == 2) {
+            solved = pruningMask<findEmptyMRVMask, findValidLCVMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 2 and emptyFinder == 1 and valueOrder == 1) {
+            solved = forwardCheckingMask<findEmptyMask, findValidMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 2 and emptyFinder == 1 and valueOrder == 2) {
+            solved = forwardCheckingMask<findEmptyMask, findValidLCVMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 2 and emptyFinder == 2 and valueOrder == 1) {
+            solved = forwardCheckingMask<findEmptyMRVMask, findValidMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        else if (method == 2 and emptyFinder == 2 and valueOrder == 2) {
+            solved = forwardCheckingMask<findEmptyMRVMask, findValidLCVMask>(maskBoard, steps, backtracks, config.stop, counter);
+        }
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                board[r][c] = maskBoard.cells[r][c]; // Copy the solved cells back to the array board
+            }
+        }
+    }
+    else if (method == 1 and emptyFinder == 1 and valueOrder == 1) {
+        solved = pruning<findEmpty, findValid>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 1 and emptyFinder == 1 and valueOrder == 2) {
+        solved = pruning<findEmpty, findValidLCV>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 1 and emptyFinder == 2 and valueOrder == 1) {
+        solved = pruning<findEmptyMRV, findValid>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 1 and emptyFinder == 2 and valueOrder == 2) {
+        solved = pruning<findEmptyMRV, findValidLCV>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 2 and emptyFinder == 1 and valueOrder == 1) {
+        solved = forwardChecking<findEmpty, findValid>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 2 and emptyFinder == 1 and valueOrder == 2) {
+        solved = forwardChecking<findEmpty, findValidLCV>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 2 and emptyFinder == 2 and valueOrder == 1) {
+        solved = forwardChecking<findEmptyMRV, findValid>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 2 and emptyFinder == 2 and valueOrder == 2) {
+        solved = forwardChecking<findEmptyMRV, findValidLCV>(board, steps, backtracks, config.stop, counter);
+    }
+    else if (method == 3 and emptyFinder == 1 and valueOrder == 1) {
+        solved = pruningMAC<findEmptyMAC, findValidMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 3 and emptyFinder == 1 and valueOrder == 2) {
+        solved = pruningMAC<findEmptyMAC, findValidLCVMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 3 and emptyFinder == 2 and valueOrder == 1) {
+        solved = pruningMAC<findEmptyMRVMAC, findValidMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 3 and emptyFinder == 2 and valueOrder == 2) {
+        solved = pruningMAC<findEmptyMRVMAC, findValidLCVMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 4 and emptyFinder == 1 and valueOrder == 1) {
+        solved = solveIterative<findEmptyMAC, findValidMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 4 and emptyFinder == 1 and valueOrder == 2) {
+        solved = solveIterative<findEmptyMAC, findValidLCVMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 4 and emptyFinder == 2 and valueOrder == 1) {
+        solved = solveIterative<findEmptyMRVMAC, findValidMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 4 and emptyFinder == 2 and valueOrder == 2) {
+        solved = solveIterative<findEmptyMRVMAC, findValidLCVMAC>(board, domains, steps, backtracks, trail, config.stop, counter);
+    }
+    else if (method == 5) { // Dancing Links exact cover: the matrix drives the search, so the heuristic options don't apply
+        static thread_local DlxSolver dlx; // ~80KB of link arrays, kept off the stack and reused across solves
+        dlx.load(board);
+        solved = dlx.search(0, steps, backtracks, config.stop, counter);
+        if (solved) {
+            for (int r = 0; r < 9; r++)
+                for (int c = 0; c < 9; c++)
+                    board[r][c] = dlx.solution[r][c]; // Copy the decoded cover back to the array board
+        }
+    }
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+    auto runtime = chrono::duration_cast<chrono::microseconds>(end - start).count(); // Calculate runtime
+
+    SolveResult result{};
+    for (int r = 0; r < 9; r++)
+        for (int c = 0; c < 9; c++)
+            result.board[r][c] = board[r][c];
+    result.solutions = solved ? 1 : 0;
+    if (counter != nullptr) { // In count mode, the search backtracks through every solution, so report the first one it recorded
+        solved = solutionCounter.count > 0;
+        result.solutions = solutionCounter.count;
+        for (int r = 0; r < 9; r++)
+            for (int c = 0; c < 9; c++)
+                result.board[r][c] = solved ? solutionCounter.firstBoard[r][c] : board[r][c];
+    }
+    result.solved = solved;
+    result.steps = steps;
+    result.backtracks = backtracks;
+    result.runtime = runtime;
+    if (config.cache != nullptr && config.countLimit < 2) {
+        bool aborted = !solved && config.stop != nullptr && config.stop->load(); // Cancelled, not exhausted, so nothing was proven
+#ifdef SUDOKU_INSTRUMENT
+        aborted = aborted || (!solved && searchStats.budgetExceeded);
+#endif
+        if (!aborted) { // Caching an aborted search would answer "unsolvable" for a board that was never searched to the end
+            SolutionCache::Entry entry;
+            entry.key = key;
+            for (int r = 0; r < 9; r++)
+                for (int c = 0; c < 9; c++)
+                    entry.board[r][c] = solved ? relabel[result.board[r][c]] : 0; // Store the solution in the key's labels
+            entry.solved = solved;
+            entry.steps = steps;
+            entry.backtracks = backtracks;
+            config.cache->put(entry);
+        }
+        result.cacheHits = config.cache->hits;
+        result.cacheMisses = config.cache->misses;
+    }
+    return result;
+}
+
+/**
+ * A 9x9 sudoku board, the input type of the library entry point
+ * @param cells The 9x9 grid of values, where 0 represents an empty square
+ */
+struct Board {
+    int cells[9][9];
+};
+
+/**
+ * Library entry point: solves a board with the given configuration, leaving the caller's board untouched
+ * The solve path performs no I/O, so the solver can be embedded and called in-process
+ * @param board The board to solve
+ * @param config The solver configuration to run
+ */
+inline SolveResult solve(const Board &board, SolverConfig config) {
+    int cells[9][9];
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            cells[r][c] = board.cells[r][c]; // Solve a copy, as the solvers mutate the board
+        }
+    }
+    return solveWithConfig(cells, config);
+}
+
+/**
+ * Solves a board on the iterative engine with checkpointing, for long solves on hosts that can be preempted mid-search
+ * When resume is set and the control's snapshot restores, the search continues exactly where the saved one left off, with steps and
+ * backtracks carried across runs; otherwise a fresh search starts from the board with the usual AC-3 preprocessing. If the search
+ * stopped early to honour a save request, control.checkpointed is set and the result reports the work done so far
+ * @param board The 9x9 puzzle board
+ * @param config The solver configuration, of which the empty square and value ordering heuristics apply
+ * @param control The checkpoint control deciding when and where to save the state
+ * @param resume Whether to try restoring the control's snapshot before starting fresh
+ */
+inline SolveResult solveCheckpointed(int board[9][9], SolverConfig config, CheckpointControl &control, bool resume) {
+    IterativeState state;
+    bool restored = false;
+    if (resume) {
+        ifstream in(control.path, ios::binary);
+        if (in.is_open()) {
+            in.seekg(0, ios::end);
+            string bytes((size_t)in.tellg(), '\0');
+            in.seekg(0);
+            in.read(&bytes[0], bytes.size());
+            restored = in.good() && state.deserialize(bytes);
+            if (!restored) {
+                state = IterativeState{}; // deserialize() fills fields as it parses, so a rejected snapshot must not leave partial state behind
+            }
+        }
+    }
+    bool consistent = true;
+    if (!restored) {
+        for (int r = 0; r < 9; r++)
+            for (int c = 0; c < 9; c++)
+                state.board[r][c] = board[r][c];
+        initDomains(state.board, state.domains);
+        if (ac3(state.domains, state.trail)) {
+            fillSingles(state.board, state.domains);
+        }
+        else {
+            consistent = false; // AC-3 detected an inconsistency, so the board is unsolvable without searching
+        }
+        state.emptyFinder = config.emptyFinder;
+        state.valueOrder = config.valueOrder;
+    }
+    control.lastSaveSteps = state.steps;
+
+    bool solved = false;
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    if (consistent) { // Dispatch on the heuristics the search was started with, so a resume matches the saved search exactly
+        if (state.emptyFinder == 1 && state.valueOrder == 1) {
+            solved = solveIterativeResumable<findEmptyMAC, findValidMAC>(state, &control);
+        }
+        else if (state.emptyFinder == 1 && state.valueOrder == 2) {
+            solved = solveIterativeResumable<findEmptyMAC, findValidLCVMAC>(state, &control);
+        }
+        else if (state.emptyFinder == 2 && state.valueOrder == 1) {
+            solved = solveIterativeResumable<findEmptyMRVMAC, findValidMAC>(state, &control);
+        }
+        else {
+            solved = solveIterativeResumable<findEmptyMRVMAC, findValidLCVMAC>(state, &control);
+        }
+    }
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+
+    SolveResult result{};
+    for (int r = 0; r < 9; r++)
+        for (int c = 0; c < 9; c++)
+            result.board[r][c] = state.board[r][c];
+    result.solved = solved;
+    result.solutions = solved ? 1 : 0;
+    result.steps = state.steps;
+    result.backtracks = state.backtracks;
+    result.runtime = chrono::duration_cast<chrono::microseconds>(end - start).count();
+    return result;
+}
+
+/**
+ * Worker for the root-split parallel search. Solves its share of the root branches sequentially (branches are handed out round robin,
+ * so every worker gets some), and publishes the first success through the winner index, which sets the shared stop flag to prune the
+ * branches still being searched by the other workers
+ * @param id The index of this worker
+ * @param threads The total number of workers, the round robin stride
+ * @param branches The boards of the root branches, one per candidate value of the split square
+ * @param results Pointer to the list of per-branch results, indexed by branch
+ * @param config The solver configuration to run on every branch, with its stop flag pointed at the shared flag
+ * @param stopFlag The shared stop flag that prunes the remaining branches once one of them succeeds
+ * @param winner The index of the first branch to find a solution, or -1 while none has
+ */
+inline void rootBranchWorker(int id, int threads, vector<Board> &branches, vector<SolveResult> &results, SolverConfig config, atomic<bool> &stopFlag, atomic<int> &winner) {
+    for (int branch = id; branch < (int)branches.size(); branch += threads) {
+        if (stopFlag.load()) {
+            return; // Another branch already found the solution, so the rest of this worker's share is pruned
+        }
+        results[branch] = solveWithConfig(branches[branch].cells, config);
+        if (results[branch].solved) {
+            int expected = -1;
+            if (winner.compare_exchange_strong(expected, branch)) {
+                stopFlag.store(true); // First success wins, cutting the losing branches short at their next node
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * Solves a single board by splitting the root of the search tree across threads: the candidate values of the first MRV square each
+ * become an independent subtree, solved concurrently with the given configuration, and the first branch to succeed prunes the rest
+ * through a shared atomic stop flag. On pathological boards where one thread would explore a huge tree, the losing root values stop
+ * costing their full subtrees, so worst case single puzzle latency drops with the core count
+ * Steps and backtracks are summed across every branch, so they report the total work done rather than the winner's share
+ * @param board The 9x9 puzzle board
+ * @param config The solver configuration to run on every branch
+ * @param threads The number of worker threads to split the root across
+ */
+inline SolveResult solveParallelRoot(int board[9][9], SolverConfig config, int threads) {
+    MaskBoard maskBoard;
+    maskBoard.load(board);
+    pair<int, int> splitSquare = findEmptyMRVMask(maskBoard); // Split the tightest square, so the branches are few and heavy
+    if (splitSquare == make_pair(-1, -1)) {
+        return solveWithConfig(board, config); // No empty squares to split on, so fall through to the plain solver
+    }
+    int row = splitSquare.first;
+    int col = splitSquare.second;
+
+    vector<Board> branches;
+    int mask = maskBoard.candidates(row, col);
+    while (mask != 0) {
+        int bit = mask & -mask; // Isolate the lowest set candidate bit
+        Board branch;
+        for (int r = 0; r < 9; r++)
+            for (int c = 0; c < 9; c++)
+                branch.cells[r][c] = board[r][c];
+        branch.cells[row][col] = countCandidates(bit - 1) + 1; // The bit position gives the value
+        branches.push_back(branch);
+        mask &= mask - 1;
+    }
+
+    auto start = chrono::steady_clock::now(); // Begin tracking runtime
+    SolveResult result{};
+    for (int r = 0; r < 9; r++)
+        for (int c = 0; c < 9; c++)
+            result.board[r][c] = board[r][c];
+    if (branches.empty()) {
+        return result; // The split square has no candidates at all, so the board is unsolvable without searching
+    }
+
+    atomic<bool> stopFlag{false};
+    atomic<int> winner{-1};
+    config.stop = &stopFlag; // Every branch checks the shared flag per node, so a win elsewhere prunes it promptly
+    config.countLimit = 1; // The branches stop at the first solution, so counting mode doesn't apply here
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > (int)branches.size()) {
+        threads = branches.size(); // No point spawning more workers than there are root branches
+    }
+    vector<SolveResult> results(branches.size());
+    vector<thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(thread(rootBranchWorker, i, threads, ref(branches), ref(results), config, ref(stopFlag), ref(winner)));
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    auto end = chrono::steady_clock::now(); // Finish tracking runtime
+
+    int won = winner.load();
+    for (int i = 0; i < (int)results.size(); i++) {
+        result.steps += results[i].steps; // Sum the work across every branch, including the pruned losers
+        result.backtracks += results[i].backtracks;
+    }
+    result.steps++; // Count the root expansion itself as a step
+    if (won != -1) {
+        for (int r = 0; r < 9; r++)
+            for (int c = 0; c < 9; c++)
+                result.board[r][c] = results[won].board[r][c];
+        result.solved = true;
+        result.solutions = 1;
+    }
+    result.runtime = chrono::duration_cast<chrono::microseconds>(end - start).count();
+    return result;
+}
+
+/**
+ * Handle for a solve running on a background thread, the non-blocking counterpart of solve() for embedding the solver in a service
+ * Submit a board with start(), then poll() without blocking, await() the result, or cancel() the search early; an optional deadline
+ * cancels it automatically. Cancellation is cooperative through the solvers' stop flag, a relaxed atomic load in the search loop
+ * that costs no measurable throughput, so a pathological board can no longer pin a thread indefinitely
+ * @param stopFlag The stop flag the running search checks, set by cancel() or the deadline
+ * @param done Whether the solve has finished and the result is ready
+ * @param result The finished solve's result, valid once done is set
+ */
+struct AsyncSolve {
+    atomic<bool> stopFlag{false};
+    atomic<bool> done{false};
+    SolveResult result{};
+    thread worker;
+    thread watcher;
+    mutex doneLock;
+    condition_variable doneSignal;
+
+    /**
+     * Submits a board to be solved on a background thread, optionally with a deadline after which the search is cancelled
+     * @param board The board to solve
+     * @param config The solver configuration to run
+     * @param deadlineUs Cancel the solve after this many microseconds, 0 for no deadline
+     */
+    void start(const Board &board, SolverConfig config, long long deadlineUs = 0) {
+        config.stop = &stopFlag;
+        worker = thread(&AsyncSolve::run, this, board, config);
+        if (deadlineUs > 0) {
+            watcher = thread(&AsyncSolve::watch, this, deadlineUs);
+        }
+    }
+
+    /**
+     * Checks whether the solve has finished, without blocking
+     */
+    bool poll() {
+        return done.load(memory_order_acquire);
+    }
+
+    /**
+     * Blocks until the solve has finished (by solving, cancellation or the deadline) and returns its result
+     */
+    SolveResult await() {
+        if (worker.joinable()) {
+            worker.join();
+        }
+        if (watcher.joinable()) {
+            watcher.join(); // The watcher wakes as soon as the worker finishes, so this doesn't wait out the deadline
+        }
+        return result;
+    }
+
+    /**
+     * Asks the running search to stop. The search unwinds at its next stop flag check and the result reports unsolved
+     */
+    void cancel() {
+        stopFlag.store(true);
+    }
+
+    /**
+     * Checks whether the solve was cancelled (explicitly or by the deadline)
+     */
+    bool cancelled() {
+        return stopFlag.load();
+    }
+
+    ~AsyncSolve() {
+        cancel(); // Never let a destroyed handle leave its search running
+        await();
+    }
+
+    /**
+     * Worker body: runs the solve, publishes the result and wakes the deadline watcher
+     * @param board The board being solved
+     * @param config The solver configuration being run
+     */
+    void run(Board board, SolverConfig config) {
+        SolveResult solved = solve(board, config);
+        {
+            lock_guard<mutex> guard(doneLock);
+            result = solved;
+            done.store(true, memory_order_release);
+        }
+        doneSignal.notify_all();
+    }
+
+    /**
+     * Deadline watcher body: waits until the deadline or until the solve finishes, whichever is first, and cancels on timeout
+     * @param deadlineUs The deadline in microseconds
+     */
+    void watch(long long deadlineUs) {
+        unique_lock<mutex> guard(doneLock);
+        auto deadline = chrono::steady_clock::now() + chrono::microseconds(deadlineUs);
+        while (!done.load()) { // Loop so a spurious wakeup doesn't cancel a still-running solve early
+            if (doneSignal.wait_until(guard, deadline) == cv_status::timeout) {
+                break;
+            }
+        }
+        if (!done.load()) {
+            cancel(); // The deadline passed with the search still running
+        }
+    }
+};
+
+/**
+ * Recursively fills the board with a complete valid solution, using MRV on the bitmask engine with the candidate values tried in random order
+ * Trying values in random order is what makes every generated board different, while MRV keeps the fill fast by expanding the most constrained square first
+ * Returns true once the board is full, and false if the current branch cannot be completed
+ * @param board The bitmask puzzle board being filled
+ * @param rng The random number generator driving the value order
+ */
+inline bool fillRandom(MaskBoard &board, mt19937 &rng) {
+    pair<int, int> emptysquare = findEmptyMRVMask(board);
+    if (emptysquare == make_pair(-1, -1)) {
+        return true;
+    }
+    int row = emptysquare.first;
+    int col = emptysquare.second;
+
+    Domain validNums;
+    findValidMask(board, row, col, validNums);
+    for (int i = validNums.size() - 1; i > 0; i--) {
+        int j = rng() % (i + 1); // Shuffle the candidate values so each fill takes a different path
+        int swap = validNums[i];
+        validNums[i] = validNums[j];
+        validNums[j] = swap;
+    }
+
+    for (int i = 0; i < validNums.size(); i++) {
+        board.place(row, col, validNums[i]);
+        if (fillRandom(board, rng)) {
+            return true;
+        }
+        board.unplace(row, col);
+    }
+    return false;
+}
+
+/**
+ * Generates a puzzle by filling an empty board with a randomized MRV search, then removing clues in random order,
+ * keeping each removal only while the counting search confirms the puzzle still has exactly one solution
+ * Removal stops once the target clue count is reached or every square has been tried, and the actual clue count is returned
+ * (dropping below ~23 clues gets increasingly unlikely, as most removals start breaking uniqueness)
+ * @param puzzle The 9x9 board the generated puzzle is written into
+ * @param targetClues Stop removing clues once this few remain
+ * @param rng The random number generator driving the fill and the removal order
+ */
+inline int generatePuzzle(int puzzle[9][9], int targetClues, mt19937 &rng) {
+    int empty[9][9] = {};
+    MaskBoard board;
+    board.load(empty);
+    fillRandom(board, rng);
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            puzzle[r][c] = board.cells[r][c];
+        }
+    }
+
+    int order[81];
+    for (int i = 0; i < 81; i++) {
+        order[i] = i;
+    }
+    for (int i = 80; i > 0; i--) {
+        int j = rng() % (i + 1); // Shuffle the removal order so the clue pattern differs between puzzles
+        int swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    SolverConfig check; // Uniqueness is checked with forward checking and MRV on the bitmask engine, the fastest configuration for near-full boards
+    check.method = 2;
+    check.emptyFinder = 2;
+    check.engine = 2;
+    check.countLimit = 2;
+
+    int clues = 81;
+    for (int i = 0; i < 81 && clues > targetClues; i++) {
+        int row = order[i] / 9;
+        int col = order[i] % 9;
+        int removed = puzzle[row][col];
+        puzzle[row][col] = 0;
+
+        int boardCopy[9][9];
+        for (int r = 0; r < 9; r++) {
+            for (int c = 0; c < 9; c++) {
+                boardCopy[r][c] = puzzle[r][c]; // Check a copy, as the solvers mutate the board
+            }
+        }
+        if (solveWithConfig(boardCopy, check).solutions == 1) {
+            clues--; // The puzzle is still unique without this clue, so the removal stands
+        }
+        else {
+            puzzle[row][col] = removed; // Removing this clue admitted a second solution, so put it back
+        }
+    }
+    return clues;
+}
+
+#endif // SUDOKU_SOLVER_H
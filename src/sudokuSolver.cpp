@@ -1,9 +1,25 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <queue>
 #include <chrono>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "solver.h"
+#include "sizedSolver.h"
 using namespace std;
 
 /** 
@@ -48,650 +64,465 @@ void readPuzzle(string fname, int board[9][9]) {
     }
 };
 
-/**
- * Checks if a specified value is valid at a given position, by checking the position's row, column and 3x3 subsqaure to see if the value is already there
+/** 
+ * Prints the solved puzzle, with subsquares separated by -s and |s 
  * @param board The 9x9 puzzle board
- * @param row The row of the position being checked
- * @param col The column of the position being checked
- * @param value The value being checked
 */
-bool isValid(int board[9][9], int row, int col, int value) {
-    for (int i=0; i < 9; i++) {
-        if (value == board[i][col] || value == board[row][i]) { // If the value is already within the position's row or column
-            return false;
+void printBoard(int board[9][9]) {
+    for (int i = 0; i < 9 ; i++) {
+        if (i % 3 == 0 && i != 0) {
+            cout << "- - - - - - - - - - -\n";
         }
-    }
-
-    int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
-    int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
-
-    for (int r = boxRow; r < boxRow + 3; r++) {
-        for (int c = boxCol; c < boxCol + 3; c++) {
-            if (value == board[r][c]) { // If the value is already within the subsquare
-                return false;
+        for (int j = 0; j < 9; j++) {
+            if (j % 3 == 0 && j != 0) {
+                cout << "| ";
+            }
+            cout << board[i][j];
+            if (j != 8) {
+                cout << " ";
             }
         }
+        cout << "\n";
     }
-    return true;
 }
-
 /**
- * Gets all the related squares (within the same row, column or 3x3 subsquare) for a given square at row, col and updates the related list with their positions
- * Filters out duplicates potentially added when searching for related squares within a row/column while searching for related squares within a 3x3 subsquare
- * @param row The row of the square
- * @param col The column of the square
- * @param related Pointer to the list of related squares
+ * Gets input from the user detailing which solve method, empty cell finding heuristic, value ordering heuristic, board engine and whether or not they want to use AC-3 preprocessing
+ * The function returns the chosen configuration as a SolverConfig
  */
-void getRelated(int row, int col, vector<pair<int, int>> &related) {
-    for (int i = 0; i < 9; i++) {
-        if (i != col) {
-            related.push_back({row, i}); // Get all squares within the same row
-        }
-        if (i != row) {
-            related.push_back({i, col}); // Get all squares within the same column
-        }
+SolverConfig promptConfig() {
+    SolverConfig config;
+    cout << "Select an approach: \n [1] Backtracking with pruning \n [2] Backtracking with forward checking \n [3] Backtracking with pruning and MAC (Maintained Arc Consistency) \n [4] MAC on the iterative engine (explicit frame stack instead of recursion) \n [5] Dancing Links exact cover (Algorithm X) \n [6] Automatic (picked from the board's root features) \n";
+    cin >> config.method;
+    if (config.method == 6) {
+        return config; // Automatic mode chooses everything itself from the root features
     }
-    int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
-    int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
-    for (int i = boxRow; i < boxRow + 3; i++) {
-        for (int j = boxCol; j < boxCol + 3; j++) {
-            if (i == row && j == col) {
-                continue;
-            }
-            bool duplicate = false;
-            for (auto &square : related) {
-                if (square.first == i && square.second == j) {
-                    duplicate = true; // Avoid adding any duplicates previously added when searching row and column
-                    break;
-                }
-            }
-            if (!duplicate) {
-                related.push_back({i, j}); // Get all squares within the same subsquare
-            }
-        }
+    if (config.method < 5) { // Dancing Links drives its own search order, so the heuristic options don't apply to it
+        cout << "Select empty cell finding heuristic: \n [1] None (first empty) \n [2] MRV (Minimum Remaining Values) \n";
+        cin >> config.emptyFinder;
+        cout << "Select value ordering heuristic: \n [1] Basic (no ordering) \n [2] LCV (Least Constraining Value) \n";
+        cin >> config.valueOrder;
+    }
+    if (config.method < 3) { // If MAC isn't being used
+        cout << "Select board engine: \n [1] Array board \n [2] Bitmask board (incremental row/column/subsquare masks) \n [3] Bitmask board with cached MRV candidate counts (square selection always uses the count buckets) \n";
+        cin >> config.engine;
+        cout << "Apply AC-3 preprocessing? \n [1] Yes \n [2] No \n";
+        cin >> config.useAC3;
     }
+    cout << "Apply hidden singles and naked pairs propagation before search? \n [1] Yes \n [2] No \n";
+    cin >> config.useRules;
+    return config;
 }
 
-/** 
- * Iterates through values 1-9, and checks if each value is valid at the given row and column, updating the list of valid values as it goes
+/**
+ * Solves a given sudoku board. Gets input from the user detailing the solver configuration, then runs it
+ * The function returns a SolveResult, containing the details of the performed solve
  * @param board The 9x9 puzzle board
- * @param row The row of the square being checked
- * @param col The column of the square being checked
- * @param validNums Pointer to the list of valid values
-*/
-void findValid(int board[9][9], int row, int col, vector<int> &validNums) {
-    for (int i = 1; i < 10; i++) { // Get a list of all possible valid values at the current empty square
-        if (isValid(board, row, col, i)) {
-            validNums.push_back(i);
+ */
+SolveResult solve(int board[9][9]) {
+    return solveWithConfig(board, promptConfig());
+}
+
+/**
+ * Reads a single puzzle from an 81 character line (one character per square, row by row), where digits 1-9 are filled squares and 0s or .s are blanks
+ * Returns true if the line contained a full 81 square puzzle and false otherwise
+ * @param line The line containing the puzzle
+ * @param board The 9x9 puzzle board to populate
+ */
+bool readPuzzleLine(const string &line, int board[9][9]) {
+    int square = 0;
+    for (int i = 0; i < line.length() && square < 81; i++) {
+        char c = line[i];
+        if (isdigit(c)) {
+            board[square / 9][square % 9] = c - '0';
+            square++;
+        }
+        else if (c == '.') { // Allow .s to represent blank squares, as used by the standard one-line formats
+            board[square / 9][square % 9] = 0;
+            square++;
         }
     }
+    return square == 81;
 }
+
 /**
- * Updates the list of valid numbers to the current domain, used for MAC solving
- * @param domains The 9x9 list of domains for each square
- * @param row The row of the square being checked
- * @param col The column of the square being checked
- * @param validNums Pointer to the list of valid values
+ * A binary puzzle corpus mapped into memory with mmap. The format is one puzzle per 81 bytes (one byte per square, row by row, 0 for blanks),
+ * so puzzle i lives at a fixed offset of i * 81 and workers read it in place with no parsing or copies, and the pages are shared between processes by the OS page cache
+ * @param data The mapped corpus bytes
+ * @param length The length of the mapping in bytes
+ * @param count The number of puzzles in the corpus
  */
-void findValidMAC(vector<int> domains[9][9], int row, int col, vector<int> &validNums) {
-    validNums = domains[row][col];
-}
+struct MappedCorpus {
+    const unsigned char *data = nullptr;
+    size_t length = 0;
+    int count = 0;
 
-/** 
- * Iterates through values 1-9 and counts the number of constraints removed for each square in the given square's row, column and subsqaure for each value
- * The list of valid values is then updated with each valid value, ordered from the least constraining to the highest constraining
- * @param board The 9x9 puzzle board
- * @param row The row of the square being checked
- * @param col The column of the square being checked
- * @param validNums Pointer to the list of valid values
-*/
-void findValidLCV(int board[9][9], int row, int col, vector<int> &validNums) {
-    vector<pair<int, int>> valueConstraints; // Pairs of values and constraint counts
-    for (int i = 1; i < 10; i++) {
-        if (!isValid(board, row, col, i)) {
-            continue; // Skip invalid values
-        }
-        int constraints = 0;
-        board[row][col] = i;
-        
-        for (int j = 0; j < 9; j++) {
-            if (board[row][j] == 0 && j != col) { // Count constraints within each row
-                for (int k = 1; k < 10; k++) {
-                    if (isValid(board, row, j, k)) {
-                        constraints++;
-                    }
-                }
-            }
-            if (board[j][col] == 0 && j != row) { // Count constraints within each column
-                for (int k = 1; k < 10; k++) {
-                    if (isValid(board, j, col, k)) {
-                        constraints++;
-                    }
-                }
-            }
+    bool open(const string &fname) {
+        int fd = ::open(fname.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return false;
         }
-        int boxRow = (row / 3) * 3; // Calculates the row of the top left square of the subsquare containing (row, col)
-        int boxCol = (col / 3) * 3; // Calculates the column of the top left square of the subsquare containing (row, col)
-        for (int r = boxRow; r < boxRow + 3; r++) { // Count constraints within each subsquare
-            for (int c = boxCol; c < boxCol + 3; c++) {
-                if (board[r][c] == 0 && (r != row || c != col)) {
-                    for (int v = 1; v < 10; v++) {
-                        if (isValid(board, r, c, v)) {
-                            constraints++;
-                        }
-                    }
-                }
-            }
+        struct stat info;
+        if (fstat(fd, &info) == -1 || info.st_size == 0 || info.st_size % 81 != 0) {
+            ::close(fd); // A valid corpus is a whole number of 81 byte puzzles
+            return false;
         }
-        board[row][col] = 0;
-        int pos = 0;
-        while (pos < valueConstraints.size() && valueConstraints[pos].second <= constraints) { 
-             pos++; // Find the position to insert the value and constraints pair, so that the vector is sorted ascendingly 
+        void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // The mapping keeps the file alive, so the descriptor isn't needed anymore
+        if (mapped == MAP_FAILED) {
+            return false;
         }
-        valueConstraints.insert(valueConstraints.begin() + pos, {i, constraints}); // Insert the pair at the correct position
-    }
-
-    for (auto &p : valueConstraints) {
-        validNums.push_back(p.first); // Update validNums with the LCV sorted valid values
+        data = static_cast<const unsigned char *>(mapped);
+        length = info.st_size;
+        count = length / 81;
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] > 9) { // Unlike the text reader, nothing else filters the bytes, and a value above 9 would reach the solvers as a garbage placement
+                close();
+                return false;
+            }
+        }
+        return true;
     }
-}
 
-/** 
- * Iterates through values in a square's domain and counts the number of constraints each value would impose on related squares
- * The list of valid values is then updated with each value, ordered from the least constraining to the most constraining
- * Uses pre-computed domains from AC-3, so calculations are faster than recalculating constraints from scratch
- * @param domains The 9x9 list of domains for each square
- * @param row The row of the square being checked
- * @param col The column of the square being checked
- * @param validNums Pointer to the list of valid values
-*/
-void findValidLCVMAC(vector<int> domains[9][9], int row, int col, vector<int> &validNums) {
-    validNums.clear();
-    vector<pair<int, int>> valueConstraints; // Pairs of values and constraint counts
-    
-    for (int val : domains[row][col]) {
-        int constraints = 0; // Count of related squares that would have only 1 choice left
-        vector<pair<int, int>> related;
-        getRelated(row, col, related);
-
-        for (auto &square : related) {
-            int squareRow = square.first;
-            int squareCol = square.second;
-            if (domains[squareRow][squareCol].empty()) continue;
-            
-            int supportedCount = 0;
-            for (int v : domains[squareRow][squareCol]) {
-                if (v != val) supportedCount++;
-            }
-            
-            if (supportedCount == 1) constraints += 100; // Heavy penalty
-            else constraints += supportedCount; // Light penalty for remaining options
+    void close() {
+        if (data != nullptr) {
+            munmap(const_cast<unsigned char *>(data), length);
+            data = nullptr;
+            length = 0;
+            count = 0;
         }
-        
-        size_t pos = 0;
-        while (pos < valueConstraints.size() && valueConstraints[pos].second <= constraints) pos++;
-        valueConstraints.insert(valueConstraints.begin() + pos, {val, constraints});
     }
-    
-    for (auto &p : valueConstraints) validNums.push_back(p.first);
-}
+};
 
 /**
- * Initialising a list of initial domains for each square, by adding the square's set value or, if empty, all its potential values to the list
- * @param board The 9x9 puzzle board
- * @param domains The 9x9 list of domains
+ * The set of puzzles for a batch run, backed by either the lines of a text file or a memory-mapped binary corpus
+ * @param lines The puzzle lines when reading a text file, null otherwise
+ * @param packed The mapped corpus bytes when reading a binary corpus, null otherwise
+ * @param count The number of puzzles in the set
  */
-void initDomains(int board[9][9], vector<int> domains[9][9]) {
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            domains[i][j].clear(); // Clear any previously set domains
-            if (board[i][j] != 0) {
-                domains[i][j].push_back(board[i][j]); // Limit preset squares' domains to their preset value
-                continue;
-            }
-            for (int k = 1; k <= 9; k++) {
-                if (isValid(board, i, j, k)) {
-                    domains[i][j].push_back(k); // Iteratively add all valid values to the domain
-                }
+struct BatchPuzzles {
+    const vector<string> *lines = nullptr;
+    const unsigned char *packed = nullptr;
+    int count = 0;
+
+    bool get(int i, int board[9][9]) const {
+        if (packed != nullptr) {
+            const unsigned char *squares = packed + static_cast<size_t>(i) * 81; // Fixed stride, so puzzle i is indexed directly with no parsing
+            for (int square = 0; square < 81; square++) {
+                board[square / 9][square % 9] = squares[square];
             }
+            return true;
         }
+        return readPuzzleLine((*lines)[i], board);
     }
-}
+};
 
 /**
- * Updates the domain of squarei by removing any values of the domain where that value is the only value within the domain of squarej
- * Returns true if the domain was updated and false otherwise
- * @param domains The 9x9 list of domains
- * @param squarei The position of the square's domain that's being updated
- * @param squarej the position of the square that squarei is being checked against
+ * Converts a text puzzle file (one 81 character puzzle per line, or the 9 line CSV layout used in puzzles/) into the binary corpus format
+ * read by the memory-mapped batch mode: 81 bytes per puzzle, one byte per square, row by row, with 0 for blanks
+ * @param inName The name/path of the text puzzle file
+ * @param outName The name/path of the binary corpus to write
  */
-bool update(vector<int> domains[9][9], pair<int, int> squarei, pair<int, int> squarej) {
-    bool updated = false;
-    vector<int> newDomain;
-    for (int i : domains[squarei.first][squarei.second]) { // For each value in squarei's domain
-        bool valid = false;
-        for (int j : domains[squarej.first][squarej.second]) { // For each value in squarej's domain
-            if (i != j) {
-                valid = true; // The value within squarei's domain is valid if it isn't the only value within squarej's domain
-                break;
+void convertCorpus(string inName, string outName) {
+    ifstream in(inName);
+    if (!in.is_open()) {
+        cout << "Could not open file: " << inName << "\n";
+        return;
+    }
+
+    vector<unsigned char> bytes;
+    string line;
+    while (getline(in, line)) {
+        int board[9][9] = {};
+        if (readPuzzleLine(line, board)) {
+            for (int square = 0; square < 81; square++) {
+                bytes.push_back(board[square / 9][square % 9]);
             }
         }
-        if (valid) {
-            newDomain.push_back(i);
-        }
-        else {
-            updated = true;
+    }
+    if (bytes.empty()) { // No 81 character lines, so treat the file as a single puzzle in the 9 line CSV layout
+        int board[9][9] = {};
+        readPuzzle(inName, board);
+        for (int square = 0; square < 81; square++) {
+            bytes.push_back(board[square / 9][square % 9]);
         }
     }
-    domains[squarei.first][squarei.second] = newDomain; // Update squarei's domain
-    return updated;
+
+    ofstream out(outName, ios::binary);
+    if (!out.is_open()) {
+        cout << "Could not open file: " << outName << "\n";
+        return;
+    }
+    out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+    cout << "Wrote " << (bytes.size() / 81) << " puzzles to " << outName << "\n";
 }
 
 /**
- * Applies the AC-3 algorithm to enforce arc consistency on all squares, by generating arcs and updating domains
- * Returns false if an inconsistency is detected, and true otherwise
- * @param domains The 9x9 list of domains
+ * Buffered result writer for the batch mode. Per-puzzle output is appended to a large in-memory buffer and flushed with
+ * big write() calls, so stream formatting and small writes never become the throughput ceiling of the multi-threaded batch mode
+ * Writing to a .bin path produces a compact binary corpus of solved boards (81 bytes per puzzle, the same layout as the input corpora),
+ * while any other path (or stdout) gets one line per puzzle with the metrics, optionally followed by the solved board as 81 characters
+ * @param buffer The pending output bytes, flushed once they pass the threshold
+ * @param fd The file descriptor being written to (1 for stdout)
+ * @param binary Whether results are written in the 81 byte binary board format
  */
-bool ac3(vector<int> domains[9][9]) {
-    queue<pair<pair<int, int>, pair<int, int>>> arcs;
-    vector<pair<int, int>> related;
-    for (int i = 0; i < 9; i ++) {
-        for (int j = 0; j < 9; j++) {
-            getRelated(i, j, related); // Get related squares for each square
-            for(auto &square : related) {
-                arcs.push({{i, j}, square}); // Add arcs for each square x related square
-            }
-            related.clear();
+struct BatchResultWriter {
+    static const size_t FlushThreshold = 1 << 16; // Flush in 64KB batches, large enough to keep write() calls off the hot path
+
+    string buffer;
+    int fd = 1;
+    bool binary = false;
+
+    /**
+     * Opens the results destination, or leaves the writer pointed at stdout if no path was given
+     * A .bin path selects the binary board format, matching the corpus naming convention of the batch input
+     * Returns false if the file could not be created
+     * @param path The results file path, or an empty string for stdout
+     */
+    bool open(const string &path) {
+        if (path.empty()) {
+            return true;
         }
+        binary = path.length() > 4 && path.substr(path.length() - 4) == ".bin";
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return fd != -1;
     }
 
-    while (!arcs.empty()) {
-        auto arc = arcs.front();
-        arcs.pop();
-        auto squarei = arc.first;
-        auto squarej = arc.second;
-        if (update(domains, squarei, squarej)) {
-            if (domains[squarei.first][squarei.second].empty()) {
-                return false; // If the domain is empty, there is an inconsistency
+    /**
+     * Appends one puzzle's result to the buffer, flushing if the buffer has grown past the threshold
+     * @param index The puzzle's index within the batch
+     * @param result The solve result being written
+     * @param withBoard Whether to append the solved board to the line in the text format
+     */
+    void add(int index, const SolveResult &result, bool withBoard) {
+        if (binary) {
+            for (int square = 0; square < 81; square++) {
+                buffer.push_back((char)(result.solved ? result.board[square / 9][square % 9] : 0)); // Unsolvable puzzles stay zeroed, keeping the fixed stride
             }
-            related.clear();
-            getRelated(squarei.first, squarei.second, related);
-            for (auto &square : related) {
-                if (square.first == squarei.first && square.second == squarei.second) {
-                    continue;
+        }
+        else {
+            buffer += "Puzzle ";
+            buffer += to_string(index + 1);
+            buffer += result.solved ? ": solved (" : ": unsolvable (";
+            buffer += to_string(result.steps);
+            buffer += " steps, ";
+            buffer += to_string(result.backtracks);
+            buffer += " backtracks, ";
+            buffer += to_string(result.runtime);
+            buffer += "us)";
+            if (result.cacheHit) {
+                buffer += " (cached)";
+            }
+            if (withBoard && result.solved) {
+                buffer += ' ';
+                for (int square = 0; square < 81; square++) {
+                    buffer += (char)('0' + result.board[square / 9][square % 9]);
                 }
-                arcs.push({square, squarei}); // Readd arcs with updated domains
             }
+            buffer += '\n';
+        }
+        if (buffer.size() >= FlushThreshold) {
+            flush();
         }
     }
-    return true;
-}
 
-/**
- * Fills squares with single value domains with their value
- * @param board The 9x9 puzzle board
- * @param domains The 9x9 list of domains
- */
-void fillSingles(int board[9][9], vector<int> domains[9][9]) {
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            if (board[i][j] == 0 && domains[i][j].size() == 1) {
-                board[i][j] = domains[i][j][0];
+    /**
+     * Writes the whole buffer out in as few write() calls as the descriptor allows, then clears it
+     */
+    void flush() {
+        size_t written = 0;
+        while (written < buffer.size()) {
+            ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+            if (n <= 0) {
+                break; // Give up rather than spin if the descriptor stops accepting writes
             }
+            written += n;
         }
+        buffer.clear();
     }
-}
 
-/** 
- * Iterates through the board, checking for an empty square (represented by 0) and returning its location if found
- * @param board The 9x9 puzzle board
-*/
-pair<int, int> findEmpty(int board[9][9]) {
-    for (int i = 0; i < 9; i++) { // for each row
-        for (int j = 0; j < 9; j++) { // for each column
-            if (board[i][j] == 0) {
-                return {i, j};
-            }
+    /**
+     * Flushes any remaining output and closes the file, leaving stdout open
+     */
+    void close() {
+        flush();
+        if (fd != 1) {
+            ::close(fd);
         }
     }
-    return {-1, -1}; // return impossible location if none found
-}
+};
 
 /**
- * Iterates through the board, checking for an empty square (represented by 0) and returning its location if found. Used for MAC solving
- * @param board The 9x9 puzzle board
- * @param domains The 9x9 list of domains for each square
+ * A per-worker queue of puzzle indices for the multi-threaded batch mode
+ * Each worker pops work from the front of its own queue, and steals from the back of other workers' queues once its own runs dry
+ * @param items The queue of puzzle indices assigned to this worker
+ * @param lock Mutex guarding the queue, taken by both the owner and any stealing workers
  */
-pair<int, int> findEmptyMAC(int board[9][9], vector<int> domains[9][9]) {
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            if (board[i][j] == 0) {
-                return {i, j};
-            }
-        }
-    }
-    return {-1, -1};
-}
+struct WorkerQueue {
+    deque<int> items;
+    mutex lock;
+};
 
 /**
- * Iterates through the board, and uses the Minimum Remaining Value heuristic to determine the next empty square to be filled
- * The function iterates through empty squares on the board, and returns the position of the one with the least remaining valid values
- * @param board The 9x9 puzzle board
+ * Worker loop for the multi-threaded batch mode. Solves puzzles from its own queue until empty, then steals from the busiest other queue
+ * Hard puzzles can take orders of magnitude longer than easy ones, so stealing keeps all workers busy where a static split would stall
+ * @param id The index of this worker's own queue
+ * @param queues The per-worker queues of puzzle indices
+ * @param puzzles The set of puzzles being solved
+ * @param results Pointer to the list of per-puzzle results, indexed by puzzle
+ * @param config The solver configuration to run over every puzzle
  */
-pair<int, int> findEmptyMRV(int board[9][9]) {
-    int smallest = 10; // Default best number of possible values +1 for comparisons
-    pair<int, int> square = {-1, -1};
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            if (board[i][j] != 0) { // Skip filled squares
-                continue;
+void batchWorker(int id, vector<WorkerQueue> &queues, const BatchPuzzles &puzzles, vector<SolveResult> &results, SolverConfig config) {
+    while (true) {
+        int puzzle = -1;
+        {
+            lock_guard<mutex> guard(queues[id].lock);
+            if (!queues[id].items.empty()) {
+                puzzle = queues[id].items.front(); // Take work from the front of our own queue
+                queues[id].items.pop_front();
             }
-            vector<int> validNums;
-            findValid(board, i, j, validNums);
-            if (validNums.size() < smallest) {
-                smallest = validNums.size();
-                square = {i, j};
-                if (smallest == 0 || smallest == 1) { // Exit early if a dead end or the lowest possible amount of valid values is found
-                    return square;
+        }
+        if (puzzle == -1) {
+            int victim = -1;
+            int most = 0;
+            for (int i = 0; i < queues.size(); i++) { // Find the queue with the most remaining work to steal from
+                if (i == id) {
+                    continue;
+                }
+                lock_guard<mutex> guard(queues[i].lock);
+                if ((int)queues[i].items.size() > most) {
+                    most = queues[i].items.size();
+                    victim = i;
                 }
             }
-        }
-    }
-    return square;
-}
-/**
- * Iterates through the board, and uses the Minimum Remaining Value heuristic to determine the next empty square to be filled
- * The function iterates through empty squares on the board, and returns the position of the one with the smallest domain size
- * @param board The 9x9 ppuzzle board
- * @param domains The 9x9 list of domains for each square
- */
-pair<int, int> findEmptyMRVMAC(int board[9][9], vector<int> domains[9][9]) {
-    int smallest = 10; // Default best number of possible values +1 for comparisons
-    pair<int, int> square = {-1, -1};
-    for (int i = 0; i < 9; i++) {
-        for (int j = 0; j < 9; j++) {
-            if (board[i][j] != 0) { // Skip filled squares
-                continue;
+            if (victim == -1) {
+                return; // No work left anywhere, so this worker is done
             }
-            int domainSize = domains[i][j].size();
-            if (domainSize < smallest) {
-                smallest = domainSize;
-                square = {i, j};
-                if (smallest == 0 || smallest == 1) { // Exit early if a dead end or the lowest possible amount of valid values is found
-                    return square;
-                }
+            lock_guard<mutex> guard(queues[victim].lock);
+            if (queues[victim].items.empty()) {
+                continue; // The work was taken between scanning and locking, look again
             }
+            puzzle = queues[victim].items.back(); // Steal from the back, away from the owner's end
+            queues[victim].items.pop_back();
         }
-    }
-    return square;
-}
 
-/**
- * Checks if any empty squares on the board have no possible remaining values
- * @param board The 9x9 puzzle board
- */
-bool hasFuture(int board[9][9]) {
-    for(int i = 0; i < 9; i++) {
-        for(int j = 0; j < 9; j++) {
-            if (board[i][j] != 0) {
-                continue;
-            }
-            bool anyVal = false;
-            for (int v = 1; v < 10 ; v++) {
-                if (isValid(board, i, j, v)) {
-                    anyVal = true;
-                }
-            }
-            if (anyVal == false) {
-                return false;
-            }
+        int board[9][9] = {}; // Each worker reads into its own board, as the solvers mutate it
+        if (puzzles.get(puzzle, board)) {
+            results[puzzle] = solveWithConfig(board, config);
         }
     }
-    return true;
 }
 
 /**
- * Recursively solves the sudoku using backtracking with pruning, by recursively checking each valid value within each square and backtracking if none exist.
- * Returns true once the board is solved, and returns false if the board is unsolvable.
- * @param board The 9x9 puzzle board
- * @param steps The running total of steps used to solve the puzzle
- * @param backtracks The running total of backtracks used when solving the puzzle
- * @param nextEmpty The function used to find the next empty square, decided by user input
- * @param validNumFinder The function used to find and order the valid numbers that make up a square's domain
-*/
-bool pruning(int board[9][9], int &steps, int &backtracks, function<pair<int, int>(int[9][9])> nextEmpty, function<void(int[9][9], int, int, vector<int>&)> validNumFinder) {
-    pair<int, int> emptysquare = nextEmpty(board);
-    if (emptysquare == make_pair(-1, -1)) {
-        return true; // If no empty squares remain, assume the board to be solved
+ * Solves every puzzle in a multi-puzzle file with a single solver configuration, printing per-puzzle results and aggregate throughput stats
+ * The file is either text (one 81 character puzzle per line) or, for .bin files, a memory-mapped binary corpus (81 bytes per puzzle) indexed in place with no parsing
+ * With more than one thread, puzzles are distributed round robin across per-worker queues and balanced by work stealing
+ * Per-puzzle results go through the buffered writer: to stdout by default, or to a results file (.bin for the binary board format)
+ * @param fname The name/path of the file containing the puzzles
+ * @param config The solver configuration to run over every puzzle
+ * @param threads The number of worker threads to solve with
+ * @param outName The results file path, or an empty string to write results to stdout
+ * @param showBoards Whether to append each solved board to its result line in the text format
+ */
+void batchSolve(string fname, SolverConfig config, int threads, string outName, bool showBoards) {
+    BatchPuzzles puzzles;
+    MappedCorpus corpus;
+    vector<string> lines;
+    if (fname.length() > 4 && fname.substr(fname.length() - 4) == ".bin") { // .bin files are read as memory-mapped binary corpora
+        if (!corpus.open(fname)) {
+            cout << "Could not open corpus file: " << fname << "\n";
+            return;
+        }
+        puzzles.packed = corpus.data;
+        puzzles.count = corpus.count;
     }
-    int row = emptysquare.first;
-    int col = emptysquare.second;
-    steps++;
-
-    vector<int> validNums;
-    validNumFinder(board, row, col, validNums);
-
-    for (int i=0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
-        board[row][col] = validNums[i];
-        if (pruning(board, steps, backtracks, nextEmpty, validNumFinder)) {
-            return true;
+    else {
+        ifstream f(fname);
+        if (!f.is_open()) {
+            cout << "Could not open file: " << fname << "\n";
+            return;
         }
-        else {
-            backtracks++;
-            board[row][col] = 0;
+        string line;
+        while (getline(f, line)) {
+            int board[9][9] = {};
+            if (readPuzzleLine(line, board)) { // Keep only lines containing a full 81 square puzzle
+                lines.push_back(line);
+            }
         }
+        puzzles.lines = &lines;
+        puzzles.count = lines.size();
     }
-    return false;
-}
 
-/**
- * Recursively solves the sudoku using backtracking with forward checking, by placing a valid value within a square then checking if doing so elimates all valid values for any other squares
- * Returns true once the board is solved, and returns false if the board is unsolvable.
- * @param board The 9x9 puzzle board
- * @param steps The running total of steps used to solve the puzzle
- * @param backtracks The running total of backtracks used when solving the puzzle
- * @param nextEmpty The function used to find the next empty square, decided by user input
- * @param validNumFinder The function used to find and order the valid numbers that make up a square's domain
-*/
-bool forwardChecking(int board[9][9], int &steps, int &backtracks, function<pair<int, int>(int[9][9])> nextEmpty, function<void(int[9][9], int, int, vector<int>&)> validNumFinder) {
-    pair<int, int> emptysquare = nextEmpty(board);
-    if (emptysquare == make_pair(-1, -1)) {
-        return true; // If no empty squares remain, assume the board to be solved
-    }
-    int row = emptysquare.first;
-    int col = emptysquare.second;
-    steps++;
-
-    vector<int> validNums;
-    validNumFinder(board, row, col, validNums);
-
-    for(int i = 0; i < validNums.size(); i++) { // Recursively place valid numbers into empty positions until the board is solved
-        board[row][col] = validNums[i];
-        if (!hasFuture(board)) { // If placing a value into this square eliminates all possible values for any other square, backtrack
-            board[row][col] = 0;
-            backtracks++;
-            continue;
-        }
-        if (forwardChecking(board, steps, backtracks, nextEmpty, validNumFinder)) {
-            return true;
-        }
-        else {
-            backtracks++;
-            board[row][col] = 0;
-        }
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > puzzles.count && puzzles.count > 0) {
+        threads = puzzles.count; // No point spawning more workers than there are puzzles
     }
-    return false;
-}
 
-/**
- * Recursively solves the sudoku using backtracking with pruning and MAC, by placing a valid value within a square
- * The algorithm then checks all related squares domains to detect if all values have been eliminated, and prunes the path if so
- * Returns true once the board is solved, and returns false if the board is unsolvable.
- * @param board The 9x9 puzzle board
- * @param domains The 9x9 list of domains for each square
- * @param steps The running total of steps used to solve the puzzle
- * @param backtracks The running total of backtracks used when solving the puzzle
- * @param nextEmpty The function used to find the next empty square, decided by user input
- * @param validNumFinder The function used to find and order the valid numbers that make up a square's domain
-*/
-bool pruningMAC(int board[9][9], vector<int> domains[9][9], int &steps, int &backtracks, function<pair<int, int>(int[9][9], vector<int>[9][9])> nextEmpty, function<void(vector<int>[9][9], int, int, vector<int>&)> validNumFinder) {
-    pair<int, int> emptysquare = nextEmpty(board, domains);
-    if (emptysquare == make_pair(-1, -1)) {
-        return true; // If no empty squares remain, assume the board to be solved
-    }
-    int row = emptysquare.first;
-    int col = emptysquare.second;
-    steps++;
-
-    vector<int> validNums;
-    validNumFinder(domains, row, col, validNums);
-
-    for(int i = 0; i < validNums.size(); i++) {
-        vector<int> domainsCopy[9][9];
-        for (int i = 0; i < 9; i++) {
-            for (int j = 0; j < 9; j++) {
-                domainsCopy[i][j] = domains[i][j];
-            }
-        }
-        board[row][col] = validNums[i];
-        domainsCopy[row][col] = {validNums[i]};
+    vector<SolveResult> results(puzzles.count);
+    auto batchStart = chrono::steady_clock::now(); // Begin tracking the whole batch's runtime
 
-        if (ac3(domainsCopy)) {
-            if (pruningMAC(board, domainsCopy, steps, backtracks, nextEmpty, validNumFinder)) {
-                for (int i = 0; i < 9; i++)
-                    for (int j = 0; j < 9; j++)
-                        domains[i][j] = domainsCopy[i][j];
-                return true;
-            }
+    if (threads == 1) {
+        for (int i = 0; i < puzzles.count; i++) {
+            int board[9][9] = {};
+            puzzles.get(i, board);
+            results[i] = solveWithConfig(board, config);
         }
-        backtracks++;
-        board[row][col] = 0;
     }
-    return false;
-}
-
-/** 
- * Prints the solved puzzle, with subsquares separated by -s and |s 
- * @param board The 9x9 puzzle board
-*/
-void printBoard(int board[9][9]) {
-    for (int i = 0; i < 9 ; i++) {
-        if (i % 3 == 0 && i != 0) {
-            cout << "- - - - - - - - - - -\n";
+    else {
+        vector<WorkerQueue> queues(threads);
+        for (int i = 0; i < puzzles.count; i++) {
+            queues[i % threads].items.push_back(i); // Distribute puzzles round robin as the starting split
         }
-        for (int j = 0; j < 9; j++) {
-            if (j % 3 == 0 && j != 0) {
-                cout << "| ";
-            }
-            cout << board[i][j];
-            if (j != 8) {
-                cout << " ";
-            }
+        vector<thread> workers;
+        for (int i = 0; i < threads; i++) {
+            workers.push_back(thread(batchWorker, i, ref(queues), cref(puzzles), ref(results), config));
+        }
+        for (auto &worker : workers) {
+            worker.join();
         }
-        cout << "\n";
     }
-}
-/** 
- * Stores the outcome of a solver run, including the final board state and metrics
- * @param board The 9x9 solved (or attempted) puzzle board
- * @param solved Whether the solver found a valid solution
- * @param steps The total number of recursion steps performed
- * @param backtracks The total number of backtracks performed
- * @param runtime The elapsed solving time in milliseconds
- */
-struct SolveResult {
-    int board[9][9];
-    bool solved;
-    int steps;
-    int backtracks;
-    int runtime;
-};
+    auto batchEnd = chrono::steady_clock::now(); // Finish tracking the batch's runtime
+    double seconds = chrono::duration_cast<chrono::microseconds>(batchEnd - batchStart).count() / 1000000.0;
 
-/**
- * Solves a given sudoku board. Gets input from the user detailing which solve method, empty cell finding heuristic, value ordering heuristic and whether or not they want to use AC-3 preprocessing
- * The function returns a SolveResult, containing the details of the performed solve
- * @param board The 9x9 puzzle board
- */
-SolveResult solve(int board[9][9]) {
-    bool solved = false;
-    int steps = 0;
-    int backtracks = 0;
-    int method; // Selected option for solving method
-    int emptyFinder; // Selected option for empty finding heuristic
-    int valueOrder; // Selected option for value orderingheuristic
-    int useAC3; // Selected option for whether or not to use AC-3 preprocessing
-
-    vector<int> domains[9][9];
-    cout << "Select an approach: \n [1] Backtracking with pruning \n [2] Backtracking with forward checking \n [3] Backtracking with pruning and MAC (Maintained Arc Consistency) \n";
-    cin >> method;
-    cout << "Select empty cell finding heuristic: \n [1] None (first empty) \n [2] MRV (Minimum Remaining Values) \n";
-    cin >> emptyFinder;
-    cout << "Select value ordering heuristic: \n [1] Basic (no ordering) \n [2] LCV (Least Constraining Value) \n";
-    cin >> valueOrder;
-    if (method < 3) { // If MAC isn't being used
-        cout << "Apply AC-3 preprocessing? \n [1] Yes \n [2] No \n";
-        cin >> useAC3;
+    BatchResultWriter writer;
+    if (!writer.open(outName)) {
+        cout << "Could not open results file: " << outName << "\n";
+        corpus.close();
+        return;
     }
-
-    if(useAC3 == 1 || method == 3) { // If AC-3 preprocessing is enabled or MAC was chosen
-        initDomains(board, domains);
-        if (!ac3(domains)) {
-            cout << "No solution exists for the entered sudoku (AC-3 detected an inconsistency).";
-            return {-1, -1, -1};
+    cout.flush(); // The writer bypasses cout, so push any pending stream output out first to keep the ordering
+    int solvedCount = 0;
+    long long totalSteps = 0;
+    long long totalBacktracks = 0;
+    for (int i = 0; i < results.size(); i++) {
+        if (results[i].solved) {
+            solvedCount++;
         }
-        fillSingles(board, domains);
+        totalSteps += results[i].steps;
+        totalBacktracks += results[i].backtracks;
+        writer.add(i, results[i], showBoards);
     }
+    writer.close();
 
-    auto start = chrono::steady_clock::now(); // Begin tracking runtime
-    if (method == 1 and emptyFinder == 1 and valueOrder == 1) {
-        solved = pruning(board, steps, backtracks, findEmpty, findValid);
-    }
-    else if (method == 1 and emptyFinder == 1 and valueOrder == 2) {
-        solved = pruning(board, steps, backtracks, findEmpty, findValidLCV);
-    }
-    else if (method == 1 and emptyFinder == 2 and valueOrder == 1) {
-        solved = pruning(board, steps, backtracks, findEmptyMRV, findValid);
-    }
-    else if (method == 1 and emptyFinder == 2 and valueOrder == 2) {
-        solved = pruning(board, steps, backtracks, findEmptyMRV, findValidLCV);
-    }
-    else if (method == 2 and emptyFinder == 1 and valueOrder == 1) {
-        solved = forwardChecking(board, steps, backtracks, findEmpty, findValid);
-    }
-    else if (method == 2 and emptyFinder == 1 and valueOrder == 2) {
-        solved = forwardChecking(board, steps, backtracks, findEmpty, findValidLCV);
-    }
-    else if (method == 2 and emptyFinder == 2 and valueOrder == 1) {
-        solved = forwardChecking(board, steps, backtracks, findEmptyMRV, findValid);
-    }
-    else if (method == 2 and emptyFinder == 2 and valueOrder == 2) {
-        solved = forwardChecking(board, steps, backtracks, findEmptyMRV, findValidLCV);
-    }
-    else if (method == 3 and emptyFinder == 1 and valueOrder == 1) {
-        solved = pruningMAC(board, domains, steps, backtracks, findEmptyMAC, findValidMAC);
-    }
-    else if (method == 3 and emptyFinder == 1 and valueOrder == 2) {
-        solved = pruningMAC(board, domains, steps, backtracks, findEmptyMAC, findValidLCVMAC);
+    cout << "------------------- \n";
+    cout << "Puzzles: " << puzzles.count << " (" << solvedCount << " solved)\n";
+    cout << "Total steps: " << totalSteps << "\n";
+    cout << "Total backtracks: " << totalBacktracks << "\n";
+    cout << "Batch runtime: " << seconds << "s\n";
+    cout << "Threads: " << threads << "\n";
+    if (seconds > 0) {
+        cout << "Throughput: " << (puzzles.count / seconds) << " puzzles/sec\n";
     }
-    else if (method == 3 and emptyFinder == 2 and valueOrder == 1) {
-        solved = pruningMAC(board, domains, steps, backtracks, findEmptyMRVMAC, findValidMAC);
+    if (config.cache != nullptr) {
+        cout << "Cache: " << config.cache->hits << " hits, " << config.cache->misses << " misses\n";
     }
-    else if (method == 3 and emptyFinder == 2 and valueOrder == 2) {
-        solved = pruningMAC(board, domains, steps, backtracks, findEmptyMRVMAC, findValidLCVMAC);
+    if (!outName.empty()) {
+        cout << "Results written to " << outName << "\n";
     }
-    auto end = chrono::steady_clock::now(); // Finish tracking runtime
-    auto runtime = chrono::duration_cast<chrono::milliseconds>(end - start).count(); // Calculate runtime
-
-    SolveResult result{};
-    for (int r = 0; r < 9; r++)
-        for (int c = 0; c < 9; c++)
-            result.board[r][c] = board[r][c];
-    result.solved = solved;
-    result.steps = steps;
-    result.backtracks = backtracks;
-    result.runtime = runtime;
-    return result;
+    corpus.close();
 }
+
 /**
  * Compares multiple solvers, determined by the user. Each solver's stats are then printed, along with the least/most steps, backtracks and the slowest/fastest runtime, with comparisons between them
  * @param board The 9x9 puzzle board
@@ -744,7 +575,7 @@ void comparison(int board[9][9]) {
                 leastBacktracks.first = (i + 1);
                 leastBacktracks.second = results[i];
             }
-            cout << "Runtime: " << results[i].runtime << "ms \n";
+            cout << "Runtime: " << results[i].runtime << "us \n";
             if (results[i].runtime > slowest.second.runtime) {
                 slowest.first = (i + 1);
                 slowest.second = results[i];
@@ -763,12 +594,12 @@ void comparison(int board[9][9]) {
     cout << "------------------- \n";
     cout << "Solver that used the most amount of steps: " << mostSteps.first << " (" << mostSteps.second.steps << " steps)\n";
     cout << "Solver that backtracked the most: " << mostBacktracks.first << " (" << mostBacktracks.second.backtracks << " backtracks)\n";
-    cout << "Solver that solved the puzzle the slowest: " << slowest.first << " (" << slowest.second.runtime << "ms)\n";
+    cout << "Solver that solved the puzzle the slowest: " << slowest.first << " (" << slowest.second.runtime << "us)\n";
 
     cout << "------------------- \n";
     cout << "Solver that used the least amount of steps: " << leastSteps.first << " (" << leastSteps.second.steps << " steps)\n";
     cout << "Solver that backtracked the least: " << leastBacktracks.first << " (" << leastBacktracks.second.backtracks << " backtracks)\n";
-    cout << "Solver that solved the puzzle the fastest: " << fastest.first << " (" << fastest.second.runtime << "ms)\n";
+    cout << "Solver that solved the puzzle the fastest: " << fastest.first << " (" << fastest.second.runtime << "us)\n";
 
     double stepDiff = (static_cast<double>(slowest.second.steps) / static_cast<double>(fastest.second.steps));
     double backtrackDiff = (static_cast<double>(slowest.second.backtracks) / static_cast<double>(fastest.second.backtracks));
@@ -780,35 +611,801 @@ void comparison(int board[9][9]) {
     cout << "Solver " << fastest.first << " shortened solver " << slowest.first << "'s solving time by " << runtimeDiff << "%\n";
 }
 
+#ifdef SUDOKU_INSTRUMENT
+/**
+ * Prints the instrumentation recorded during the last solve on this thread: per-depth node counts, the backtrack depth distribution,
+ * the most wiped out squares, the propagation versus search time split, and whether a budget aborted the solve
+ * Only compiled into instrumented builds (-DSUDOKU_INSTRUMENT), where the solvers record into the thread local searchStats
+ * @param runtime The total runtime of the solve in microseconds, used to split propagation time from search time
+ */
+void printSearchStats(long long runtime) {
+    cout << "------------------- \n";
+    if (searchStats.budgetExceeded) {
+        cout << "Budget exceeded: the solve was aborted and these stats are partial.\n";
+    }
+    cout << "Nodes: " << searchStats.totalNodes << "\n";
+    cout << "Nodes per depth:";
+    for (int d = 1; d < 82; d++) {
+        if (searchStats.nodesAtDepth[d] > 0) {
+            cout << " " << d << ":" << searchStats.nodesAtDepth[d];
+        }
+    }
+    cout << "\n";
+    cout << "Backtracks per depth:";
+    for (int d = 1; d < 82; d++) {
+        if (searchStats.backtracksAtDepth[d] > 0) {
+            cout << " " << d << ":" << searchStats.backtracksAtDepth[d];
+        }
+    }
+    cout << "\n";
+
+    vector<pair<long long, int>> wipeouts; // Pairs of wipeout count and square index, for sorting
+    for (int square = 0; square < 81; square++) {
+        if (searchStats.wipeouts[square] > 0) {
+            wipeouts.push_back({searchStats.wipeouts[square], square});
+        }
+    }
+    sort(wipeouts.rbegin(), wipeouts.rend());
+    cout << "Most wiped out squares:";
+    for (int i = 0; i < wipeouts.size() && i < 5; i++) {
+        cout << " (" << (wipeouts[i].second / 9) << ", " << (wipeouts[i].second % 9) << "):" << wipeouts[i].first;
+    }
+    cout << "\n";
+
+    long long searchUs = runtime - searchStats.propagationUs;
+    if (searchUs < 0) {
+        searchUs = 0; // The propagation scopes round up, so clamp rather than report negative search time
+    }
+    cout << "Propagation time: " << searchStats.propagationUs << "us\n";
+    cout << "Search time: " << searchUs << "us\n";
+}
+#endif // SUDOKU_INSTRUMENT
+
+/**
+ * Worker for the portfolio race mode: solves its own copy of the board with one configuration, and claims the race if it solves first
+ * The winner sets the shared stop flag, which is checked in the solver recursion, so the losing searches unwind instead of running to completion
+ * @param id The index of this racer
+ * @param board The 9x9 puzzle board being raced
+ * @param config The solver configuration this racer runs
+ * @param stopFlag The stop flag shared by every racer, set once the race is won
+ * @param winner The index of the winning racer, -1 while the race is still open
+ * @param results Pointer to the list of per-racer results, indexed by racer
+ */
+void portfolioRacer(int id, int board[9][9], SolverConfig config, atomic<bool> &stopFlag, atomic<int> &winner, vector<SolveResult> &results) {
+    int boardCopy[9][9];
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            boardCopy[r][c] = board[r][c]; // Each racer solves its own copy, as the solvers mutate the board
+        }
+    }
+    config.stop = &stopFlag;
+    results[id] = solveWithConfig(boardCopy, config);
+    if (results[id].solved) {
+        int expected = -1;
+        if (winner.compare_exchange_strong(expected, id)) { // The first racer to solve claims the race
+            stopFlag.store(true); // Tell the other racers to stop searching
+        }
+    }
+}
+
+/**
+ * Races multiple solver configurations against the same puzzle on separate threads, taking the first solution and cancelling the rest
+ * Where one heuristic pathologically degrades on a hard puzzle, the race is bounded by the best configuration in the set instead of the one that happened to be picked
+ * @param board The 9x9 puzzle board
+ */
+void portfolio(int board[9][9]) {
+    int racers;
+    cout << "Enter how many solver configurations you would like to race (2-4): \n";
+    cin >> racers;
+    if (racers < 2) {
+        racers = 2;
+    }
+    if (racers > 4) {
+        racers = 4;
+    }
+    vector<SolverConfig> configs(racers);
+    for (int i = 0; i < racers; i++) {
+        cout << "----- Racer " << (i + 1) << " ----- \n";
+        configs[i] = promptConfig();
+    }
+
+    atomic<bool> stopFlag(false);
+    atomic<int> winner(-1);
+    vector<SolveResult> results(racers);
+    auto raceStart = chrono::steady_clock::now(); // Begin tracking the whole race's wall time
+    vector<thread> threads;
+    for (int i = 0; i < racers; i++) {
+        threads.push_back(thread(portfolioRacer, i, board, configs[i], ref(stopFlag), ref(winner), ref(results)));
+    }
+    for (auto &racer : threads) {
+        racer.join();
+    }
+    auto raceEnd = chrono::steady_clock::now(); // Finish tracking the race's wall time
+    long long raceTime = chrono::duration_cast<chrono::microseconds>(raceEnd - raceStart).count();
+
+    if (winner.load() == -1) {
+        cout << "No solution exists for the entered sudoku.\n";
+        return;
+    }
+    SolveResult &result = results[winner.load()];
+    cout << "Racer " << (winner.load() + 1) << " won the race.\n";
+    cout << "Solved Board:\n";
+    printBoard(result.board);
+    cout << "Steps: " << result.steps << "\n";
+    cout << "Backtracks: " << result.backtracks << "\n";
+    cout << "Runtime: " << result.runtime << "us\n";
+    cout << "Race wall time: " << raceTime << "us\n";
+}
+
+/**
+ * Counts a puzzle's solutions up to a limit with a single solver configuration, sharing the solvers' heuristics and propagation
+ * A limit of 2 proves or disproves uniqueness, and the search stops the moment the limit is reached, so checking costs barely more than a single solve
+ * @param board The 9x9 puzzle board
+ * @param config The solver configuration to count with
+ */
+void countSolutions(int board[9][9], SolverConfig config) {
+    if (config.countLimit < 2) {
+        cout << "Enter the maximum number of solutions to search for (2 checks uniqueness): \n";
+        cin >> config.countLimit;
+        if (config.countLimit < 2) {
+            config.countLimit = 2;
+        }
+    }
+
+    SolveResult result = solveWithConfig(board, config);
+    if (result.solutions == 0) {
+        cout << "No solution exists for the entered sudoku.\n";
+        return;
+    }
+    if (result.solutions >= config.countLimit) {
+        cout << "Solutions found: " << result.solutions << " (stopped at the limit, more may exist)\n";
+    }
+    else {
+        cout << "Solutions found: " << result.solutions << "\n";
+    }
+    if (config.countLimit == 2) {
+        cout << "The puzzle " << (result.solutions == 1 ? "has a unique solution." : "does not have a unique solution.") << "\n";
+    }
+    cout << "First solution:\n";
+    printBoard(result.board);
+    cout << "Steps: " << result.steps << "\n";
+    cout << "Backtracks: " << result.backtracks << "\n";
+    cout << "Runtime: " << result.runtime << "us\n";
+}
+
+atomic<bool> checkpointRequested{false}; // Set by the signal handler, checked by the checkpointed search at every step
+
+/**
+ * Signal handler for the checkpointed solve mode: asks the running search to snapshot its state and stop
+ * @param signum The signal number, unused
+ */
+void onCheckpointSignal(int signum) {
+    checkpointRequested.store(true);
+}
+
+/**
+ * Solves a puzzle on the iterative engine with checkpointing, resuming from the snapshot file if one exists
+ * SIGINT and SIGTERM make the search write its snapshot and exit instead of losing the work, so a preempted run costs only
+ * the steps since the last save; periodic snapshots every intervalSteps steps bound the replay even without a warning signal
+ * @param board The 9x9 puzzle board
+ * @param config The solver configuration, of which the empty square and value ordering heuristics apply
+ * @param snapshotPath The snapshot file path
+ * @param intervalSteps Write a snapshot every this many steps (0 to save only on a signal)
+ */
+void checkpointedSolve(int board[9][9], SolverConfig config, string snapshotPath, long long intervalSteps) {
+    CheckpointControl control;
+    control.path = snapshotPath;
+    control.intervalSteps = intervalSteps;
+    control.request = &checkpointRequested;
+
+    ifstream probe(snapshotPath);
+    bool resume = probe.is_open();
+    probe.close();
+    if (resume) {
+        cout << "Resuming from snapshot " << snapshotPath << "\n";
+    }
+
+    signal(SIGINT, onCheckpointSignal); // A preemption notice saves a snapshot instead of killing the search
+    signal(SIGTERM, onCheckpointSignal);
+    SolveResult result = solveCheckpointed(board, config, control, resume);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+
+    if (control.checkpointed) {
+        cout << "Checkpoint written to " << snapshotPath << " after " << result.steps << " steps. Run again with the same snapshot to resume.\n";
+        return;
+    }
+    if (result.solved) {
+        cout << "Solved Board:\n";
+        printBoard(result.board);
+        cout << "Steps: " << result.steps << (resume ? " (including the resumed search)" : "") << "\n";
+        cout << "Backtracks: " << result.backtracks << (resume ? " (including the resumed search)" : "") << "\n";
+        cout << "Runtime: " << result.runtime << "us (this run only)\n";
+    }
+    else {
+        cout << "No solution exists for the entered sudoku.\n";
+    }
+    remove(snapshotPath.c_str()); // The search finished, so a stale snapshot mustn't hijack the next run
+}
+
+/**
+ * Runs a single solver configuration repeatedly over a corpus of puzzle files, reporting min/median/p99 runtimes in microseconds
+ * Warmup runs are discarded so cold caches don't skew the stats, and the medians can be written to or compared against a baseline file to detect performance regressions between releases
+ */
+void benchmark() {
+    SolverConfig config = promptConfig();
+    int files;
+    cout << "Enter the number of puzzle files in the corpus: \n";
+    cin >> files;
+    vector<string> names(files);
+    for (int i = 0; i < files; i++) {
+        cout << "Enter puzzle file name " << (i + 1) << ": \n";
+        cin >> names[i];
+    }
+    int warmup;
+    int runs;
+    cout << "Enter the number of warmup runs per puzzle (discarded): \n";
+    cin >> warmup;
+    cout << "Enter the number of timed runs per puzzle: \n";
+    cin >> runs;
+    int baselineMode;
+    string baselineFile;
+    cout << "Baseline handling: \n [1] None \n [2] Write medians to a baseline file \n [3] Compare medians against a baseline file \n";
+    cin >> baselineMode;
+    if (baselineMode == 2 || baselineMode == 3) {
+        cout << "Enter baseline file name: \n";
+        cin >> baselineFile;
+    }
+
+    vector<pair<string, long long>> medians; // Pairs of puzzle file names and their median runtimes
+    for (int i = 0; i < files; i++) {
+        int board[9][9] = {};
+        readPuzzle("puzzles/" + names[i], board);
+        vector<long long> times;
+        times.reserve(runs);
+        for (int run = 0; run < warmup + runs; run++) {
+            int boardCopy[9][9];
+            for (int r = 0; r < 9; r++) {
+                for (int c = 0; c < 9; c++) {
+                    boardCopy[r][c] = board[r][c]; // Solve a fresh copy each run, as the solvers mutate the board
+                }
+            }
+            auto start = chrono::steady_clock::now();
+            solveWithConfig(boardCopy, config);
+            auto end = chrono::steady_clock::now();
+            if (run >= warmup) { // Discard warmup runs
+                times.push_back(chrono::duration_cast<chrono::microseconds>(end - start).count());
+            }
+        }
+        sort(times.begin(), times.end());
+        long long minTime = times[0];
+        long long median = times[times.size() / 2];
+        long long p99 = times[min<size_t>((times.size() * 99) / 100, times.size() - 1)];
+        cout << names[i] << ": min " << minTime << "us, median " << median << "us, p99 " << p99 << "us (" << runs << " runs)\n";
+        medians.push_back({names[i], median});
+    }
+
+    if (baselineMode == 2) {
+        ofstream out(baselineFile);
+        for (auto &entry : medians) {
+            out << entry.first << " " << entry.second << "\n"; // One puzzle file and median runtime per line
+        }
+        cout << "Baseline written to " << baselineFile << "\n";
+    }
+    else if (baselineMode == 3) {
+        ifstream in(baselineFile);
+        if (!in.is_open()) {
+            cout << "Could not open baseline file: " << baselineFile << "\n";
+            return;
+        }
+        vector<pair<string, long long>> baseline;
+        string name;
+        long long median;
+        while (in >> name >> median) {
+            baseline.push_back({name, median});
+        }
+        cout << "------------------- \n";
+        for (auto &entry : medians) {
+            for (auto &old : baseline) {
+                if (old.first == entry.first) {
+                    double change = old.second > 0 ? ((static_cast<double>(entry.second) - old.second) / old.second) * 100 : 0;
+                    cout << entry.first << ": baseline " << old.second << "us, now " << entry.second << "us (" << (change >= 0 ? "+" : "") << change << "%)\n";
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Reads a generic-size puzzle from a file of comma separated values (Size rows of Size numbers, with 0 for blank squares)
+ * Returns true if the file contained a full puzzle and false otherwise
+ * @param fname The name/path of the file containing the puzzle
+ * @param cells The puzzle board to populate
+ */
+template<int Size>
+bool readSizedPuzzle(const string &fname, int cells[Size][Size]) {
+    ifstream f(fname);
+    if (!f.is_open()) {
+        cout << "Could not open file: " << fname << "\n";
+        return false;
+    }
+    string text((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    for (int i = 0; i < text.length(); i++) {
+        if (text[i] == ',') {
+            text[i] = ' '; // Values can be multi-digit, so split on the commas rather than scanning characters
+        }
+    }
+    istringstream values(text);
+    int count = 0;
+    int value;
+    while (count < Size * Size && values >> value) {
+        if (value < 0 || value > Size) { // An out-of-range value would shift past the candidate mask, so reject the file instead
+            cout << "Expected values between 0 and " << Size << " but found " << value << "\n";
+            return false;
+        }
+        cells[count / Size][count % Size] = value;
+        count++;
+    }
+    if (count != Size * Size) {
+        cout << "Expected " << (Size * Size) << " values but found " << count << "\n";
+        return false;
+    }
+    cout << "Puzzle read successfully.\n";
+    return true;
+}
+
+/**
+ * Prints a generic-size board, with subsquares separated by -s and |s and values padded to two characters
+ * @param cells The puzzle board
+ */
+template<int Size>
+void printSizedBoard(int cells[Size][Size]) {
+    int box = SizedBoard<Size>::Box;
+    for (int i = 0; i < Size; i++) {
+        if (i % box == 0 && i != 0) {
+            for (int j = 0; j < Size + box - 1; j++) {
+                cout << "- -";
+            }
+            cout << "\n";
+        }
+        for (int j = 0; j < Size; j++) {
+            if (j % box == 0 && j != 0) {
+                cout << " | ";
+            }
+            if (cells[i][j] < 10) {
+                cout << " "; // Pad single digit values so the columns line up
+            }
+            cout << cells[i][j];
+            if (j != Size - 1) {
+                cout << " ";
+            }
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Reads and solves a 16x16 or 25x25 puzzle with the generic-size engine, printing the solved board and the solver's metrics
+ * @param fname The name/path of the file containing the puzzle
+ */
+template<int Size>
+void solveSizedPuzzle(const string &fname) {
+    int cells[Size][Size] = {};
+    if (!readSizedPuzzle<Size>(fname, cells)) {
+        return;
+    }
+    SizedResult<Size> result = solveSized<Size>(cells);
+    if (result.solved) {
+        cout << "Solved Board:\n";
+        printSizedBoard<Size>(result.cells);
+        cout << "Steps: " << result.steps << "\n";
+        cout << "Backtracks: " << result.backtracks << "\n";
+        cout << "Runtime: " << result.runtime << "us\n";
+    }
+    else {
+        cout << "No solution exists for the entered sudoku.\n";
+    }
+}
+
 /**
- * Main function that takes input for the name of the sudoku puzzle file and whether single solve or comparison solve is to be used
+ * Grades a puzzle's difficulty by solving it with a fixed reference configuration (pruning with MRV on the bitmask engine)
+ * and thresholding the backtrack count, so grades stay comparable across puzzles, runs and machines
+ * @param board The 9x9 puzzle board
+ * @param result Pointer to the reference solve's result, for reporting the metrics behind the grade
+ */
+string gradePuzzle(int board[9][9], SolveResult &result) {
+    SolverConfig reference;
+    reference.emptyFinder = 2;
+    reference.engine = 2;
+    int boardCopy[9][9];
+    for (int r = 0; r < 9; r++) {
+        for (int c = 0; c < 9; c++) {
+            boardCopy[r][c] = board[r][c]; // Grade a copy, as the solvers mutate the board
+        }
+    }
+    result = solveWithConfig(boardCopy, reference);
+    if (result.backtracks == 0) {
+        return "Easy"; // Solvable by propagation and direct placement alone
+    }
+    if (result.backtracks < 50) {
+        return "Medium";
+    }
+    if (result.backtracks < 500) {
+        return "Hard";
+    }
+    return "Expert";
+}
+
+/**
+ * Generates puzzles in-process on the solver core: each board is filled by a randomized MRV search, clues are removed while the
+ * counting search confirms uniqueness, and the result is graded by the reference solve's metrics
+ * Every generated puzzle is printed as a board and as an 81 character line, ready for the batch and corpus formats
+ * @param count The number of puzzles to generate
+ * @param targetClues Stop removing clues once this few remain
+ * @param seed The random seed, or -1 to seed from the system
+ */
+void generatePuzzles(int count, int targetClues, long long seed) {
+    mt19937 rng(seed >= 0 ? (unsigned int)seed : random_device{}());
+    for (int i = 0; i < count; i++) {
+        int puzzle[9][9];
+        int clues = generatePuzzle(puzzle, targetClues, rng);
+        SolveResult result;
+        string grade = gradePuzzle(puzzle, result);
+
+        cout << "----- Puzzle " << (i + 1) << " ----- \n";
+        printBoard(puzzle);
+        string line;
+        for (int square = 0; square < 81; square++) {
+            line += (char)('0' + puzzle[square / 9][square % 9]); // The 81 character form, ready for batch files
+        }
+        cout << line << "\n";
+        cout << "Clues: " << clues << "\n";
+        cout << "Difficulty: " << grade << " (" << result.steps << " steps, " << result.backtracks << " backtracks)\n";
+    }
+}
+
+/**
+ * Holds the options given on the command line. Every field defaults to unset, and unset options fall back to the matching interactive prompt,
+ * so a fully specified command line runs straight from exec to solving with no stdin round trips
+ * @param mode The mode to run (1 solve, 2 compare, 3 batch, 4 benchmark, 5 convert, 6 portfolio race, 7 count solutions, 8 generate, 9 sized solve)
+ * @param puzzle The path of the puzzle file, used as given (no puzzles/ prefix)
+ * @param out The output path for the convert mode, used as given
+ * @param config The solver configuration built from the --method/--empty/--order/--engine/--ac3 flags
+ * @param configComplete Whether enough configuration flags were given to skip the configuration prompts
+ * @param threads The number of worker threads for batch mode
+ * @param clues The target clue count for the generator mode
+ * @param seed The random seed for the generator mode, -1 to seed from the system
+ * @param size The board size for the sized solve mode (16 or 25)
+ * @param useCache Whether to share a solution cache across the batch mode's solves
+ */
+struct CliOptions {
+    int mode = -1;
+    string puzzle;
+    string out;
+    SolverConfig config;
+    bool configComplete = false;
+    int threads = -1;
+    int clues = -1;
+    long long seed = -1;
+    int size = -1;
+    int useCache = -1;
+    int boards = -1;
+    string snapshot;
+    long long interval = -1;
+};
+
+/**
+ * Prints the accepted command line flags
+ */
+void printUsage() {
+    cout << "Usage: sudokuSolver [options]\n"
+         << "  --mode <1-11>    1 solve, 2 compare, 3 batch, 4 benchmark, 5 convert to binary corpus, 6 portfolio race, 7 count solutions, 8 generate, 9 sized solve, 10 parallel solve, 11 checkpointed solve\n"
+         << "  --puzzle <path>  puzzle file path (used as given)\n"
+         << "  --out <path>     output path for convert mode, or the batch results file (.bin writes solved boards in the binary corpus format)\n"
+         << "  --method <1-6>   1 pruning, 2 forward checking, 3 MAC, 4 MAC on the iterative engine, 5 Dancing Links exact cover, 6 automatic from root features\n"
+         << "  --empty <1-2>    1 first empty, 2 MRV\n"
+         << "  --order <1-2>    1 basic, 2 LCV\n"
+         << "  --engine <1-3>   1 array board, 2 bitmask board, 3 bitmask board with cached MRV counts\n"
+         << "  --ac3 <1-2>      1 apply AC-3 preprocessing, 2 don't\n"
+         << "  --rules <1-2>    1 apply hidden singles/naked pairs before search, 2 don't\n"
+         << "  --threads <n>    worker threads for batch mode\n"
+         << "  --count <n>      number of solutions to search for in count mode (2 checks uniqueness)\n"
+         << "  --clues <n>      target clue count for the generator mode\n"
+         << "  --seed <n>       random seed for the generator mode\n"
+         << "  --size <16|25>   board size for the sized solve mode\n"
+         << "  --cache <1-2>    1 share a solution cache across batch solves, 2 don't\n"
+         << "  --boards <1-2>   1 append each solved board to its batch result line, 2 metrics only (the default)\n"
+         << "  --snapshot <path>  snapshot file for the checkpointed solve mode (resumed from if it exists)\n"
+         << "  --checkpoint-interval <n>  write a snapshot every n steps in the checkpointed solve mode (0 saves only on SIGINT/SIGTERM)\n"
+         << "  --cache-normalize <1-2>  1 normalize cache keys under digit relabeling, 2 don't\n"
+         << "  --node-budget <n>  abort a solve after n search nodes (instrumented builds only)\n"
+         << "  --time-budget <us> abort a solve after us microseconds of search (instrumented builds only)\n"
+         << "Options left out are prompted for interactively.\n";
+}
+
+/**
+ * Parses a flag's value as an integer, printing a message instead of letting stoll() terminate the program
+ * Returns false when the value isn't a number or has trailing characters, so the caller can fall through to the usage
+ * @param flag The flag being parsed, for the message
+ * @param value The value given for the flag
+ * @param number Pointer to the parsed number
+ */
+bool parseNumber(const string &flag, const string &value, long long &number) {
+    try {
+        size_t used = 0;
+        number = stoll(value, &used);
+        if (used != value.length()) { // Reject partial parses like "2x" instead of silently dropping the tail
+            throw invalid_argument(value);
+        }
+    }
+    catch (const exception &) {
+        cout << "Bad value for " << flag << ": " << value << "\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Parses the command line flags into a CliOptions, leaving anything not given unset so it falls back to its interactive prompt
+ * Returns false if an unknown flag, a flag with a missing value or a non-numeric value for a numeric flag was given
+ * @param argc The argument count from main
+ * @param argv The argument values from main
+ * @param options Pointer to the options being populated
+ */
+bool parseArgs(int argc, char *argv[], CliOptions &options) {
+    int method = -1;
+    int emptyFinder = -1;
+    int valueOrder = -1;
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--help") {
+            printUsage();
+            exit(0);
+        }
+        if (i + 1 >= argc) {
+            cout << "Missing value for " << flag << "\n";
+            return false;
+        }
+        string value = argv[++i];
+        if (flag == "--puzzle") { // The path flags take their values as given, everything else is a number
+            options.puzzle = value;
+            continue;
+        }
+        if (flag == "--out") {
+            options.out = value;
+            continue;
+        }
+        if (flag == "--snapshot") {
+            options.snapshot = value;
+            continue;
+        }
+        long long number = 0;
+        if (!parseNumber(flag, value, number)) {
+            return false;
+        }
+        if (flag == "--mode") {
+            options.mode = number;
+        }
+        else if (flag == "--method") {
+            method = number;
+        }
+        else if (flag == "--empty") {
+            emptyFinder = number;
+        }
+        else if (flag == "--order") {
+            valueOrder = number;
+        }
+        else if (flag == "--engine") {
+            options.config.engine = number;
+        }
+        else if (flag == "--ac3") {
+            options.config.useAC3 = number;
+        }
+        else if (flag == "--rules") {
+            options.config.useRules = number;
+        }
+        else if (flag == "--threads") {
+            options.threads = number;
+        }
+        else if (flag == "--clues") {
+            options.clues = number;
+        }
+        else if (flag == "--seed") {
+            options.seed = number;
+        }
+        else if (flag == "--size") {
+            options.size = number;
+        }
+        else if (flag == "--cache") {
+            options.useCache = number;
+        }
+        else if (flag == "--boards") {
+            options.boards = number;
+        }
+        else if (flag == "--checkpoint-interval") {
+            options.interval = number;
+        }
+        else if (flag == "--cache-normalize") {
+            options.config.cacheNormalize = number;
+        }
+        else if (flag == "--count") {
+            options.config.countLimit = number;
+        }
+        else if (flag == "--node-budget") {
+            options.config.nodeBudget = number;
+        }
+        else if (flag == "--time-budget") {
+            options.config.timeBudgetUs = number;
+        }
+        else {
+            cout << "Unknown flag: " << flag << "\n";
+            return false;
+        }
+    }
+    if (method == 5 || method == 6) { // Dancing Links and automatic mode ignore the heuristic options, so the method alone completes the configuration
+        options.config.method = method;
+        options.configComplete = true;
+    }
+    else if (method != -1 && emptyFinder != -1 && valueOrder != -1) { // Engine and AC-3 keep their defaults unless given
+        options.config.method = method;
+        options.config.emptyFinder = emptyFinder;
+        options.config.valueOrder = valueOrder;
+        options.configComplete = true;
+    }
+    return true;
+}
+
+/**
+ * Main function that runs the mode selected on the command line, prompting interactively for anything not given as a flag
  * If single solve is used, the function will also print the solver's metrics
  */
-int main() {
+int main(int argc, char *argv[]) {
     int board[9][9] = {};
-    string fileName;
-    int mode;
-    cout << "Enter sudoku puzzle file name: \n";
-    cin >> fileName;
-    readPuzzle("puzzles/" + fileName, board);
-    cout << "Choose a mode: \n [1] Solve the puzzle using a solver \n [2] Compare multiple solvers solving the puzzle \n";
-    cin >> mode;
+    CliOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    int mode = options.mode;
+    if (mode == -1) {
+        cout << "Choose a mode: \n [1] Solve a puzzle using a solver \n [2] Compare multiple solvers solving a puzzle \n [3] Batch solve a multi-puzzle file (one 81 character puzzle per line, or a .bin binary corpus) \n [4] Benchmark a solver configuration over a puzzle corpus \n [5] Convert a puzzle file to the binary corpus format \n [6] Race multiple solver configurations against a puzzle \n [7] Count a puzzle's solutions (check uniqueness) \n [8] Generate puzzles \n [9] Solve a 16x16 or 25x25 puzzle \n [10] Parallel solve (split the root branches across threads) \n [11] Checkpointed solve (snapshot and resume long searches) \n";
+        cin >> mode;
+    }
+    if (mode == 4) {
+        benchmark(); // Benchmark prompts for its own corpus of puzzle files
+        return 0;
+    }
+    if (mode == 8) { // The generator needs no puzzle file
+        int count;
+        cout << "Enter how many puzzles to generate: \n";
+        cin >> count;
+        int targetClues = options.clues;
+        if (targetClues == -1) {
+            cout << "Enter the target clue count (the generator stops removing clues once this few remain): \n";
+            cin >> targetClues;
+        }
+        generatePuzzles(count, targetClues, options.seed);
+        return 0;
+    }
+
+    string puzzlePath = options.puzzle;
+    if (puzzlePath.empty()) {
+        string fileName;
+        cout << "Enter sudoku puzzle file name: \n";
+        cin >> fileName;
+        puzzlePath = "puzzles/" + fileName; // Prompted file names are looked up in the puzzles directory, as before
+    }
+
+    if (mode == 9) {
+        int size = options.size;
+        if (size == -1) {
+            cout << "Enter the board size: \n [16] 16x16 \n [25] 25x25 \n";
+            cin >> size;
+        }
+        if (size == 25) {
+            solveSizedPuzzle<25>(puzzlePath);
+        }
+        else {
+            solveSizedPuzzle<16>(puzzlePath); // 16x16 is the default variant
+        }
+        return 0;
+    }
+    if (mode == 5) {
+        string outPath = options.out;
+        if (outPath.empty()) {
+            string outName;
+            cout << "Enter output corpus file name: \n";
+            cin >> outName;
+            outPath = "puzzles/" + outName; // Prompted file names live in the puzzles directory, like the inputs
+        }
+        convertCorpus(puzzlePath, outPath);
+        return 0;
+    }
+    if (mode == 3) {
+        SolverConfig config = options.configComplete ? options.config : promptConfig(); // Choose the configuration once, then run it over every puzzle in the file
+        int threads = options.threads;
+        if (threads == -1) {
+            cout << "Enter the number of worker threads (1 for single-threaded): \n";
+            cin >> threads;
+        }
+        SolutionCache cache;
+        if (options.useCache == 1) {
+            config.cache = &cache; // One cache shared by every batch worker, so duplicate boards become lookups
+        }
+        batchSolve(puzzlePath, config, threads, options.out, options.boards == 1);
+        return 0;
+    }
+    readPuzzle(puzzlePath, board);
     if (mode == 1) {
+        SolverConfig config = options.configComplete ? options.config : promptConfig();
+        if (config.method == 6) {
+            selectAutoConfig(board, config); // Resolve the automatic choice here so it can be reported alongside the result
+            cout << "Auto configuration: method " << config.method << ", empty finder " << config.emptyFinder << ", value order " << config.valueOrder << ", engine " << config.engine << "\n";
+        }
         SolveResult result{};
-        result = solve(board);
+        result = solveWithConfig(board, config);
         if (result.solved) {
             cout << "Solved Board:\n";
             printBoard(result.board);
             cout << "Steps: " << result.steps << "\n";
             cout << "Backtracks: " << result.backtracks << "\n";
-            cout << "Runtime: " << result.runtime << "ms\n";
+            cout << "Runtime: " << result.runtime << "us\n";
         }
         else {
             cout << "No solution exists for the entered sudoku.\n";
         }
+#ifdef SUDOKU_INSTRUMENT
+        printSearchStats(result.runtime); // Instrumented builds report what the search did, even for aborted or unsolvable boards
+#endif
     }
     else if (mode == 2) {
         comparison(board);
     }
+    else if (mode == 6) {
+        portfolio(board);
+    }
+    else if (mode == 7) {
+        countSolutions(board, options.configComplete ? options.config : promptConfig());
+    }
+    else if (mode == 10) {
+        SolverConfig config = options.configComplete ? options.config : promptConfig();
+        int threads = options.threads;
+        if (threads == -1) {
+            cout << "Enter the number of worker threads to split the root across: \n";
+            cin >> threads;
+        }
+        SolveResult result = solveParallelRoot(board, config, threads);
+        if (result.solved) {
+            cout << "Solved Board:\n";
+            printBoard(result.board);
+            cout << "Steps: " << result.steps << " (summed across all root branches)\n";
+            cout << "Backtracks: " << result.backtracks << " (summed across all root branches)\n";
+            cout << "Runtime: " << result.runtime << "us\n";
+        }
+        else {
+            cout << "No solution exists for the entered sudoku.\n";
+        }
+    }
+    else if (mode == 11) {
+        SolverConfig config = options.config;
+        if (!options.configComplete) { // Checkpointing runs on the iterative engine, so only its heuristics need choosing
+            cout << "Select empty cell finding heuristic: \n [1] None (first empty) \n [2] MRV (Minimum Remaining Values) \n";
+            cin >> config.emptyFinder;
+            cout << "Select value ordering heuristic: \n [1] Basic (no ordering) \n [2] LCV (Least Constraining Value) \n";
+            cin >> config.valueOrder;
+        }
+        string snapshotPath = options.snapshot;
+        if (snapshotPath.empty()) {
+            cout << "Enter the snapshot file path: \n";
+            cin >> snapshotPath;
+        }
+        long long interval = options.interval;
+        if (interval == -1) {
+            cout << "Enter the checkpoint interval in steps (0 to save only on SIGINT/SIGTERM): \n";
+            cin >> interval;
+        }
+        checkpointedSolve(board, config, snapshotPath, interval);
+    }
     return 0;
 }
\ No newline at end of file